@@ -1,50 +1,730 @@
 #pragma once
 #include "def.h"
 
+#include <stdatomic.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+typedef enum {
+    ARENA_FLAG_NONE              = 0,
+    ARENA_FLAG_LARGE_PAGES       = BIT(0),  // Back the arena with huge/large pages when the OS allows it
+    ARENA_FLAG_DECOMMIT_ON_RESET = BIT(1),  // Give committed pages back to the OS on arena_reset
+    ARENA_FLAG_GROWABLE          = BIT(2),  // Chain spill blocks instead of failing when the reservation runs out
+} ArenaFlags;
+
+// Overflow block of a growable arena, the header sits at the start of its own reservation.
+// Spill blocks are kept on the chain across resets so later frames reuse them.
+typedef struct ArenaSpill {
+    struct ArenaSpill* next;
+    usize size;             // Reserved bytes, header included
+    usize offset;
+    usize committed;        // Committed in the arena's commit_granule steps, like the base block
+    uint32 index;           // 1-based position in the chain
+} ArenaSpill;
+
+// Debug builds track every arena allocation, define ARENA_TELEMETRY=0 to opt out
+#if !defined(ARENA_TELEMETRY) && defined(DEBUG_MODE)
+#define ARENA_TELEMETRY 1
+#endif
+
+constexpr int ARENA_MAX_CALLSITES = 64;
+constexpr int ARENA_CALLSITE_FILE_MAX = 96;
+
+typedef struct {
+    // A copy, the __FILE__ literal of a hot-reloaded DLL is unmapped along with it
+    char file[ARENA_CALLSITE_FILE_MAX];
+    int line;
+    uint32 alloc_count;
+    usize bytes;
+} ArenaCallsite;
+
+// Usage counts the base block and the spill blocks in use, see arena_get_used
+typedef struct {
+    usize high_water;           // Largest usage ever reached
+    usize frame_peak;           // Largest usage since the last arena_reset
+    usize last_frame_peak;      // frame_peak of the frame that was just reset
+    usize max_frame_peak;       // Largest frame_peak over all frames
+    uint64 alloc_count;
+    uint64 bytes_allocated;
+    uint64 failed_alloc_count;
+    uint64 reset_count;
+    uint32 callsite_count;
+    uint32 untracked_alloc_count; // Allocations from callsites that didn't fit the table
+    ArenaCallsite callsites[ARENA_MAX_CALLSITES];
+} ArenaStats;
+
 typedef struct {
     uint8* memory;
-    usize size;
+    usize size;             // Reserved address space
     usize offset;
+    usize committed;        // Bytes backed by physical memory, always a multiple of commit_granule
+    usize commit_granule;   // Commit step (page size, or huge page size for ARENA_FLAG_LARGE_PAGES)
+    uint32 flags;
+    uint32 temp_count;      // Open arena_temp_begin scopes
+    ArenaSpill* spill_first;    // Every spill block ever chained, in order
+    ArenaSpill* spill_current;  // Block taking allocations, nullptr while the base block has room
+    uint32 spill_peak;          // Most spill blocks a single frame needed
+#if ARENA_TELEMETRY
+    ArenaStats stats;
+#endif
 } Arena;
 
-// TODO: Use platform-specific allocation functions
-Arena create_arena(usize size) {
+typedef struct {
+    Arena* arena;
+    usize offset;
+    ArenaSpill* spill;
+    usize spill_offset;
+    uint32 depth;
+} ArenaTemp;
+
+constexpr usize ARENA_COMMIT_GRANULE = KB(64);
+constexpr usize ARENA_LARGE_PAGE_SIZE = MB(2);
+
+static inline usize arena_align_up(usize value, usize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static usize os_page_size(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (usize)info.dwPageSize;
+#else
+    return (usize)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+static void* os_reserve(usize size) {
+#ifdef _WIN32
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* memory = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+#endif
+}
+
+// Reserves and commits the whole range on explicit large pages. Returns nullptr when the
+// OS has none to give (no hugetlbfs pool / missing SeLockMemoryPrivilege).
+static void* os_reserve_large(usize size) {
+#if defined(_WIN32)
+    usize large_page = GetLargePageMinimum();
+    if (large_page == 0 || size % large_page != 0) return nullptr;
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+#elif defined(MAP_HUGETLB)
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+#else
+    (void)size;
+    return nullptr;
+#endif
+}
+
+static bool os_commit(void* memory, usize size) {
+#ifdef _WIN32
+    return VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    return mprotect(memory, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+static void os_decommit(void* memory, usize size) {
+#ifdef _WIN32
+    VirtualFree(memory, size, MEM_DECOMMIT);
+#else
+    madvise(memory, size, MADV_DONTNEED);
+    mprotect(memory, size, PROT_NONE);
+#endif
+}
+
+static void os_release(void* memory, usize size) {
+#ifdef _WIN32
+    (void)size;
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, size);
+#endif
+}
+
+/**
+ * @brief Reserves `size` bytes of address space without backing them with memory.
+ *
+ * Pages are committed in `commit_granule` steps as arena_alloc crosses the commit line,
+ * so the resident size follows what is actually used rather than the reservation.
+ */
+Arena create_arena_with_flags(usize size, uint32 flags) {
     Arena arena = {
-        .memory = (uint8*)malloc(size),
-        .size = size,
-        .offset = 0,
+        .flags = flags,
+        .commit_granule = arena_align_up(ARENA_COMMIT_GRANULE, os_page_size()),
     };
+
+    if (flags & ARENA_FLAG_LARGE_PAGES) {
+        usize large_size = arena_align_up(size, ARENA_LARGE_PAGE_SIZE);
+        arena.memory = (uint8*)os_reserve_large(large_size);
+        if (arena.memory) {
+            arena.size = large_size;
+            arena.committed = large_size;
+            arena.commit_granule = ARENA_LARGE_PAGE_SIZE;
+            // Explicit large pages are pinned, decommitting them would only split them
+            arena.flags &= ~ARENA_FLAG_DECOMMIT_ON_RESET;
+            return arena;
+        }
+
+        debug_print("Warning: Large pages unavailable, falling back to transparent huge pages\n");
+        arena.commit_granule = ARENA_LARGE_PAGE_SIZE;
+    }
+
+    usize reserve_size = arena_align_up(size, arena.commit_granule);
+    arena.memory = (uint8*)os_reserve(reserve_size);
+    if (!arena.memory) {
+        debug_print("Error: Could not reserve %.1f KB of address space for arena\n", size / 1024.0f);
+        return (Arena){};
+    }
+    arena.size = reserve_size;
+
+#ifdef MADV_HUGEPAGE
+    if (flags & ARENA_FLAG_LARGE_PAGES) {
+        madvise(arena.memory, arena.size, MADV_HUGEPAGE);
+    }
+#endif
+
     return arena;
 }
 
+Arena create_arena(usize size) {
+    return create_arena_with_flags(size, ARENA_FLAG_NONE);
+}
+
 void arena_cleanup(Arena *arena) {
-    free(arena->memory);
+    for (ArenaSpill* spill = arena->spill_first; spill;) {
+        ArenaSpill* next = spill->next;
+        os_release(spill, spill->size);
+        spill = next;
+    }
+
+    if (arena->memory) {
+        os_release(arena->memory, arena->size);
+    }
+    *arena = (Arena){};
 }
 
-void *arena_alloc(Arena *arena, usize size) {
-    // Align to 8 bytes for better performance
+static bool arena_commit_to(Arena* arena, usize offset) {
+    usize target = arena_align_up(offset, arena->commit_granule);
+    if (target > arena->size) target = arena->size;
+    if (target <= arena->committed) return true;
+
+    if (!os_commit(arena->memory + arena->committed, target - arena->committed)) {
+        debug_print("Error: Could not commit arena memory (committed: %.1f KB, requested: %.1f KB)\n",
+                   arena->committed / 1024.0f, target / 1024.0f);
+        return false;
+    }
+
+    arena->committed = target;
+    return true;
+}
+
+#if ARENA_TELEMETRY
+usize arena_get_used(Arena* arena);
+
+static void arena_stats_record(Arena* arena, usize size, const char* file, int line) {
+    ArenaStats* stats = &arena->stats;
+    stats->alloc_count++;
+    stats->bytes_allocated += size;
+    usize used = arena_get_used(arena);
+    if (used > stats->high_water) stats->high_water = used;
+    if (used > stats->frame_peak) stats->frame_peak = used;
+
+    // Keyed by content, the same file can come from the executable and from the game DLL.
+    // Long paths keep their tail, which is the part that tells files apart
+    usize length = strlen(file);
+    if (length >= ARENA_CALLSITE_FILE_MAX) {
+        file += length - (ARENA_CALLSITE_FILE_MAX - 1);
+    }
+
+    usize hash = (usize)line * 2654435761u;
+    for (const char* c = file; *c; c++) {
+        hash = (hash ^ (uint8)*c) * 16777619u;
+    }
+    hash %= ARENA_MAX_CALLSITES;
+
+    for (int probe = 0; probe < ARENA_MAX_CALLSITES; probe++) {
+        ArenaCallsite* callsite = &stats->callsites[(hash + probe) % ARENA_MAX_CALLSITES];
+        if (!callsite->file[0]) {
+            strcpy(callsite->file, file);
+            callsite->line = line;
+            stats->callsite_count++;
+        }
+        if (callsite->line == line && strcmp(callsite->file, file) == 0) {
+            callsite->alloc_count++;
+            callsite->bytes += size;
+            return;
+        }
+    }
+    stats->untracked_alloc_count++;
+}
+#endif
+
+static bool arena_spill_commit_to(Arena* arena, ArenaSpill* spill, usize offset) {
+    usize target = MIN(arena_align_up(offset, arena->commit_granule), spill->size);
+    if (target <= spill->committed) return true;
+
+    if (!os_commit((uint8*)spill + spill->committed, target - spill->committed)) {
+        debug_print("Error: Could not commit arena spill memory (committed: %.1f KB, requested: %.1f KB)\n",
+                   spill->committed / 1024.0f, target / 1024.0f);
+        return false;
+    }
+
+    spill->committed = target;
+    return true;
+}
+
+static inline usize arena_spill_header_size(void) {
+    return arena_align_up(sizeof(ArenaSpill), 16);
+}
+
+// Moves a growable arena on to the next spill block that fits `size` at `alignment`, reusing
+// cached blocks from earlier frames before reserving a new one. Blocks are page aligned, so
+// aligning an offset aligns the pointer. `consumed` gets the bytes the block's offset moved,
+// alignment padding included, as the base block counts them.
+static void* arena_spill_alloc(Arena* arena, usize size, usize alignment, usize* consumed) {
+    ArenaSpill* spill = arena->spill_current;
+    usize header_size = arena_spill_header_size();
+
+    if (spill) {
+        usize start = arena_align_up(spill->offset, alignment);
+        if (start + size <= spill->size) {
+            if (!arena_spill_commit_to(arena, spill, start + size)) return nullptr;
+            *consumed = start + size - spill->offset;
+            spill->offset = start + size;
+            return (uint8*)spill + start;
+        }
+    }
+
+    usize start = arena_align_up(header_size, alignment);
+    ArenaSpill* prev = spill;
+    ArenaSpill* next = spill ? spill->next : arena->spill_first;
+    if (!next || start + size > next->size) {
+        // Cached blocks past this one stay on the chain behind the new block. The reservation
+        // matches the base block, only what is used gets committed.
+        usize block_size = arena_align_up(start + size, arena->commit_granule);
+        if (block_size < arena->size) block_size = arena->size;
+
+        ArenaSpill* block = (ArenaSpill*)os_reserve(block_size);
+        if (!block || !os_commit(block, arena->commit_granule)) {
+            debug_print("Error: Could not reserve %.1f KB arena spill block\n", block_size / 1024.0f);
+            if (block) os_release(block, block_size);
+            return nullptr;
+        }
+        block->size = block_size;
+        block->committed = arena->commit_granule;
+        block->next = next;
+        if (prev) {
+            prev->next = block;
+        } else {
+            arena->spill_first = block;
+        }
+        next = block;
+    }
+
+    if (!arena_spill_commit_to(arena, next, start + size)) return nullptr;
+    next->index = prev ? prev->index + 1 : 1;
+    next->offset = start + size;
+    *consumed = start + size - header_size;
+    arena->spill_current = next;
+    if (next->index > arena->spill_peak) {
+        arena->spill_peak = next->index;
+        debug_print("Warning: Arena spilled into %u extra block(s)\n", arena->spill_peak);
+    }
+
+    return (uint8*)next + start;
+}
+
+// `alignment` is at least 8 and a power of two no larger than the OS page size
+static void* arena_alloc_internal(Arena* arena, usize size, usize alignment,
+                                  [[maybe_unused]] const char* file, [[maybe_unused]] int line) {
+    // Sizes stay multiples of 8 so the default alignment holds without padding
     usize aligned_size = (size + 7) & ~7;
-    
-    if (arena->offset + aligned_size > arena->size) {
-        debug_print("Error: Arena out of memory (requested: %.1f KB, available: %.1f KB)\n", 
-                   aligned_size / 1024.0f, (arena->size - arena->offset) / 1024.0f);
+
+    // Once a growable arena spilled, allocations stay in the chain until it is reset so
+    // temp checkpoints keep unwinding in order
+    if ((arena->flags & ARENA_FLAG_GROWABLE) &&
+        (arena->spill_current || arena_align_up(arena->offset, alignment) + aligned_size > arena->size)) {
+        usize consumed = 0;
+        void* ptr = arena_spill_alloc(arena, aligned_size, alignment, &consumed);
+#if ARENA_TELEMETRY
+        if (ptr) {
+            arena_stats_record(arena, consumed, file, line);
+        } else {
+            arena->stats.failed_alloc_count++;
+        }
+#endif
+        return ptr;
+    }
+
+    // The base is page aligned, so aligning the offset aligns the pointer
+    usize start = arena_align_up(arena->offset, alignment);
+    if (start + aligned_size > arena->size) {
+        debug_print("Error: Arena out of memory (requested: %.1f KB, available: %.1f KB) at %s:%d\n",
+                   aligned_size / 1024.0f, (arena->size - arena->offset) / 1024.0f, file, line);
+#if ARENA_TELEMETRY
+        arena->stats.failed_alloc_count++;
+#endif
+        return nullptr;
+    }
+
+    if (start + aligned_size > arena->committed &&
+        !arena_commit_to(arena, start + aligned_size)) {
+#if ARENA_TELEMETRY
+        arena->stats.failed_alloc_count++;
+#endif
         return nullptr;
     }
-    
-    void* ptr = arena->memory + arena->offset;
-    arena->offset += aligned_size;
-    
+
+    void* ptr = arena->memory + start;
+    usize consumed = start + aligned_size - arena->offset;
+    arena->offset = start + aligned_size;
+
+#if ARENA_TELEMETRY
+    arena_stats_record(arena, consumed, file, line);
+#else
+    (void)consumed;
+#endif
+
     return ptr;
 }
 
+#define arena_alloc(arena, size) arena_alloc_at((arena), (size), __FILE__, __LINE__)
+
+void* arena_alloc_at(Arena* arena, usize size, const char* file, int line) {
+    // Align to 8 bytes for better performance
+    return arena_alloc_internal(arena, size, 8, file, line);
+}
+
+#define arena_alloc_aligned(arena, size, alignment) \
+    arena_alloc_aligned_at((arena), (size), (alignment), __FILE__, __LINE__)
+
+/**
+ * @brief arena_alloc with a stronger alignment than the default 8 bytes.
+ * `alignment` must be a power of two no larger than the OS page size.
+ */
+void* arena_alloc_aligned_at(Arena* arena, usize size, usize alignment, const char* file, int line) {
+    assert((alignment & (alignment - 1)) == 0 && "Arena alignment must be a power of two");
+    return arena_alloc_internal(arena, size, MAX(alignment, (usize)8), file, line);
+}
+
 void arena_reset(Arena* arena) {
+    assert(arena->temp_count == 0 && "arena_reset called with an open arena_temp scope");
+
+#if ARENA_TELEMETRY
+    ArenaStats* stats = &arena->stats;
+    stats->reset_count++;
+    stats->last_frame_peak = stats->frame_peak;
+    if (stats->frame_peak > stats->max_frame_peak) {
+        // Warn while there is still headroom instead of waiting for arena_alloc to fail
+        if (stats->frame_peak > arena->size / 4 * 3) {
+            debug_print("Warning: Arena frame peak grew to %.1f/%.1f KB\n",
+                       stats->frame_peak / 1024.0f, arena->size / 1024.0f);
+        }
+        stats->max_frame_peak = stats->frame_peak;
+    }
+    stats->frame_peak = 0;
+#endif
+
     arena->offset = 0;
+    // Spill blocks stay cached, their offsets are reset as they are re-entered
+    arena->spill_current = nullptr;
+
+    // Keep the first granule hot, it is touched again right away
+    if ((arena->flags & ARENA_FLAG_DECOMMIT_ON_RESET) && arena->committed > arena->commit_granule) {
+        os_decommit(arena->memory + arena->commit_granule, arena->committed - arena->commit_granule);
+        arena->committed = arena->commit_granule;
+    }
+    // Spill blocks keep only the granule holding their header
+    if (arena->flags & ARENA_FLAG_DECOMMIT_ON_RESET) {
+        for (ArenaSpill* spill = arena->spill_first; spill; spill = spill->next) {
+            if (spill->committed > arena->commit_granule) {
+                os_decommit((uint8*)spill + arena->commit_granule, spill->committed - arena->commit_granule);
+                spill->committed = arena->commit_granule;
+            }
+        }
+    }
 }
 
+/**
+ * @brief Bytes in use: the base block plus the spill blocks the current frame entered.
+ */
 usize arena_get_used(Arena* arena) {
-    return arena->offset;
+    usize used = arena->offset;
+    if (!arena->spill_current) return used;
+
+    // Blocks are entered in chain order, so every block up to the current one is in use
+    for (ArenaSpill* spill = arena->spill_first; spill; spill = spill->next) {
+        used += spill->offset;
+        if (spill == arena->spill_current) break;
+    }
+    return used;
 }
 
+/**
+ * @brief Bytes that can still be allocated without reserving more address space. A growable
+ * arena counts the rest of its current spill block and the cached blocks after it.
+ */
 usize arena_get_remaining(Arena* arena) {
-    return arena->size - arena->offset;
+    ArenaSpill* spill = arena->spill_current;
+    usize remaining = spill ? spill->size - spill->offset : arena->size - arena->offset;
+
+    ArenaSpill* cached = spill ? spill->next : arena->spill_first;
+    for (; cached; cached = cached->next) {
+        remaining += cached->size - arena_spill_header_size();
+    }
+    return remaining;
+}
+
+/**
+ * @brief Bytes backed by physical memory, spill blocks included.
+ */
+usize arena_get_committed(Arena* arena) {
+    usize committed = arena->committed;
+    for (ArenaSpill* spill = arena->spill_first; spill; spill = spill->next) {
+        committed += spill->committed;
+    }
+    return committed;
+}
+
+/**
+ * @brief Number of spill blocks the current frame of a growable arena is using.
+ */
+uint32 arena_get_spill_count(Arena* arena) {
+    return arena->spill_current ? arena->spill_current->index : 0;
+}
+
+/**
+ * @brief Returns the arena's allocation telemetry, or nullptr when ARENA_TELEMETRY is off.
+ */
+ArenaStats* arena_get_stats([[maybe_unused]] Arena* arena) {
+#if ARENA_TELEMETRY
+    return &arena->stats;
+#else
+    return nullptr;
+#endif
+}
+
+static void arena_stats_write_json_string(FILE* out, const char* string) {
+    fputc('"', out);
+    for (const char* c = string; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', out);
+        fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+/**
+ * @brief Writes one row per tracked callsite of each arena as CSV.
+ */
+void arena_stats_write_csv(FILE* out, Arena** arenas, const char** names, usize count) {
+    fprintf(out, "arena,size,committed,high_water,max_frame_peak,alloc_count,file,line,callsite_allocs,callsite_bytes\n");
+    for (usize i = 0; i < count; i++) {
+        ArenaStats* stats = arena_get_stats(arenas[i]);
+        if (!stats) continue;
+
+        for (int j = 0; j < ARENA_MAX_CALLSITES; j++) {
+            ArenaCallsite* callsite = &stats->callsites[j];
+            if (!callsite->file[0]) continue;
+
+            fprintf(out, "%s,%zu,%zu,%zu,%zu,%llu,\"%s\",%d,%u,%zu\n",
+                    names[i], arenas[i]->size, arena_get_committed(arenas[i]), stats->high_water,
+                    stats->max_frame_peak, (unsigned long long)stats->alloc_count,
+                    callsite->file, callsite->line, callsite->alloc_count, callsite->bytes);
+        }
+    }
+}
+
+/**
+ * @brief Writes the stats of each arena, callsites included, as a JSON array.
+ */
+void arena_stats_write_json(FILE* out, Arena** arenas, const char** names, usize count) {
+    fprintf(out, "[\n");
+    for (usize i = 0; i < count; i++) {
+        ArenaStats* stats = arena_get_stats(arenas[i]);
+        if (!stats) continue;
+
+        fprintf(out, "  {\"name\": ");
+        arena_stats_write_json_string(out, names[i]);
+        fprintf(out, ", \"size\": %zu, \"committed\": %zu, \"high_water\": %zu, "
+                     "\"max_frame_peak\": %zu, \"last_frame_peak\": %zu, \"alloc_count\": %llu, "
+                     "\"bytes_allocated\": %llu, \"failed_alloc_count\": %llu, \"reset_count\": %llu, "
+                     "\"untracked_alloc_count\": %u, \"callsites\": [",
+                arenas[i]->size, arena_get_committed(arenas[i]), stats->high_water,
+                stats->max_frame_peak, stats->last_frame_peak,
+                (unsigned long long)stats->alloc_count, (unsigned long long)stats->bytes_allocated,
+                (unsigned long long)stats->failed_alloc_count, (unsigned long long)stats->reset_count,
+                stats->untracked_alloc_count);
+
+        bool first = true;
+        for (int j = 0; j < ARENA_MAX_CALLSITES; j++) {
+            ArenaCallsite* callsite = &stats->callsites[j];
+            if (!callsite->file[0]) continue;
+
+            fprintf(out, "%s\n    {\"file\": ", first ? "" : ",");
+            arena_stats_write_json_string(out, callsite->file);
+            fprintf(out, ", \"line\": %d, \"alloc_count\": %u, \"bytes\": %zu}",
+                    callsite->line, callsite->alloc_count, callsite->bytes);
+            first = false;
+        }
+        fprintf(out, "%s]}%s\n", first ? "" : "\n  ", i + 1 < count ? "," : "");
+    }
+    fprintf(out, "]\n");
+}
+
+/**
+ * @brief Opens a checkpoint on the arena, everything allocated until the matching
+ * arena_temp_end is released at once. Scopes nest and must be closed in LIFO order.
+ */
+ArenaTemp arena_temp_begin(Arena* arena) {
+    ArenaTemp temp = {
+        .arena = arena,
+        .offset = arena->offset,
+        .spill = arena->spill_current,
+        .spill_offset = arena->spill_current ? arena->spill_current->offset : 0,
+        .depth = ++arena->temp_count,
+    };
+    return temp;
+}
+
+void arena_temp_end(ArenaTemp temp) {
+    Arena* arena = temp.arena;
+    assert(arena->temp_count > 0 && "arena_temp_end without a matching arena_temp_begin");
+    assert(arena->temp_count == temp.depth && "arena_temp scopes must be closed in LIFO order");
+    assert(arena->offset >= temp.offset && "arena was reset inside an arena_temp scope");
+
+    arena->offset = temp.offset;
+    arena->spill_current = temp.spill;
+    if (temp.spill) {
+        temp.spill->offset = temp.spill_offset;
+    }
+    arena->temp_count--;
+}
+
+constexpr int SCRATCH_ARENA_COUNT = 2;
+constexpr usize SCRATCH_ARENA_SIZE = MB(64);
+
+// Each thread gets its own scratch arenas, so borrowing one needs no locking. They only
+// reserve address space until first used.
+static thread_local Arena scratch_arenas[SCRATCH_ARENA_COUNT];
+
+/**
+ * @brief Borrows one of the calling thread's scratch arenas for temporary allocations.
+ *
+ * Pass the arenas the caller is already allocating into as `conflicts` (e.g. an arena
+ * received as a parameter that may itself be a scratch arena) and a different one is
+ * returned, so the scratch scope never frees memory the caller still owns.
+ * Release with scratch_end.
+ */
+ArenaTemp scratch_begin(Arena** conflicts, usize conflict_count) {
+    for (int i = 0; i < SCRATCH_ARENA_COUNT; i++) {
+        Arena* scratch = &scratch_arenas[i];
+
+        bool conflicting = false;
+        for (usize j = 0; j < conflict_count; j++) {
+            if (conflicts[j] == scratch) {
+                conflicting = true;
+                break;
+            }
+        }
+        if (conflicting) continue;
+
+        if (!scratch->memory) {
+            *scratch = create_arena(SCRATCH_ARENA_SIZE);
+        }
+        return arena_temp_begin(scratch);
+    }
+
+    assert(false && "Every scratch arena conflicts, raise SCRATCH_ARENA_COUNT");
+    return (ArenaTemp){};
+}
+
+void scratch_end(ArenaTemp temp) {
+    arena_temp_end(temp);
+}
+
+/**
+ * @brief Releases the calling thread's scratch arenas, call before a thread exits.
+ */
+void scratch_thread_cleanup(void) {
+    for (int i = 0; i < SCRATCH_ARENA_COUNT; i++) {
+        if (scratch_arenas[i].memory) {
+            arena_cleanup(&scratch_arenas[i]);
+        }
+    }
+}
+
+constexpr int FRAME_ARENA_COUNT = 3;
+
+// Ring of per-frame arenas. Frame N allocates from arenas[N % FRAME_ARENA_COUNT], and that
+// arena is only reset when frame N + FRAME_ARENA_COUNT starts, after every consumer of
+// frame N retired it. Producers can hand buffers to another thread without copying.
+typedef struct {
+    Arena arenas[FRAME_ARENA_COUNT];
+    uint64 frame_index;             // Frame currently being produced
+    _Atomic(uint64) retired_count;  // Frames [0, retired_count) are no longer read by anyone
+} FrameArenas;
+
+void frame_arenas_init(FrameArenas* frames, usize size, uint32 flags) {
+    for (int i = 0; i < FRAME_ARENA_COUNT; i++) {
+        frames->arenas[i] = create_arena_with_flags(size, flags);
+    }
+    frames->frame_index = 0;
+    atomic_store(&frames->retired_count, 0);
+}
+
+void frame_arenas_cleanup(FrameArenas* frames) {
+    for (int i = 0; i < FRAME_ARENA_COUNT; i++) {
+        arena_cleanup(&frames->arenas[i]);
+    }
+}
+
+Arena* frame_arena_current(FrameArenas* frames) {
+    return &frames->arenas[frames->frame_index % FRAME_ARENA_COUNT];
+}
+
+/**
+ * @brief Signals that `frame` and every frame before it are done being consumed.
+ * Safe to call from any thread.
+ */
+void frame_arenas_retire(FrameArenas* frames, uint64 frame) {
+    uint64 retired = atomic_load(&frames->retired_count);
+    while (retired < frame + 1 &&
+           !atomic_compare_exchange_weak(&frames->retired_count, &retired, frame + 1)) {}
+}
+
+bool frame_arenas_is_retired(FrameArenas* frames, uint64 frame) {
+    return frame < atomic_load(&frames->retired_count);
+}
+
+/**
+ * @brief Ends the current frame and starts the next one, returning its index.
+ *
+ * Blocks until the frame that last used the next arena was retired, then resets it.
+ */
+uint64 frame_arenas_advance(FrameArenas* frames) {
+    frames->frame_index++;
+
+    if (frames->frame_index >= FRAME_ARENA_COUNT) {
+        uint64 previous_user = frames->frame_index - FRAME_ARENA_COUNT;
+        while (!frame_arenas_is_retired(frames, previous_user)) {
+#ifdef _WIN32
+            SwitchToThread();
+#else
+            sched_yield();
+#endif
+        }
+    }
+
+    arena_reset(frame_arena_current(frames));
+    return frames->frame_index;
 }
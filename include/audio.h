@@ -4,51 +4,187 @@
  */
 #pragma once
 #include "arena.h"
+#include "audio_adpcm.h"
+#include "audio_mix.h"
 #include "consts.h"
 #include "def.h"
+#include "hashmap.h"
+#include "job.h"
+#include "resampler.h"
+#include "ring.h"
+#include "slotmap.h"
+#include "thread.h"
 #include "stb_vorbis.c"
 
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/stat.h>
+#endif
+
+// Voices quieter than this (about -60 dB, master volume included) go virtual
+constexpr real32 AUDIO_AUDIBLE_THRESHOLD = 0.001f;
+
 typedef enum {
     AUDIO_SOURCE_NONE      = 0,  // Uninitialized/empty slot
     AUDIO_SOURCE_STATIC    = 1,  // Fully loaded in memory
     AUDIO_SOURCE_STREAMING = 2,  // Streamed from file
 } AudioSourceType;
 
+// How a static source keeps its samples, both at AUDIO_SAMPLE_RATE / AUDIO_CHANNELS
+typedef enum {
+    AUDIO_SAMPLES_PCM16 = 0,      // Interleaved int16, mixed straight from memory
+    AUDIO_SAMPLES_ADPCM = 1,      // IMA-ADPCM blocks, about 4x smaller, decoded block-wise by the mixer
+} AudioSampleFormat;
+
+// Frames the decoder thread decodes per stb_vorbis call, bounds how long it holds a stream
+constexpr usize AUDIO_DECODE_CHUNK_FRAMES = 1024;
+constexpr uint32 AUDIO_DECODER_IDLE_MS = 2;
+
+// Decode side of a streaming source. It lives in the permanent arena so the decoder thread
+// can hold on to it while the AudioSource moves around the dense slot map.
+typedef struct {
+    stb_vorbis* vorbis;           // Only used by the decoder thread while the stream is not paused
+    SpscRing ring;                // Interleaved frames at AUDIO_SAMPLE_RATE, decoder produces, mixer consumes
+    usize lookahead_frames;       // The decoder keeps at least this much buffered
+    int channels;
+    bool loop;
+
+    // Streams at other rates are converted on the decoder thread, before the ring
+    bool resample;
+    bool flushed;                 // Decoder: the end of the input was pushed into the resampler
+    Resampler resampler;
+
+    _Atomic(bool) paused;         // Main thread: the decoder must leave the stream alone
+    _Atomic(bool) decoding;       // Decoder: currently working on the stream
+    _Atomic(bool) end_of_stream;  // Decoder: the last frames of a non-looping stream are in the ring
+    bool started;                 // Mixer: frames arrived since the last restart, only then can it starve
+    uint32 starved_blocks;        // Blocks the ring ran dry before the end of the stream
+} AudioStream;
+
+// Lifetime of a lazy source's samples. The main thread moves them out of EVICTED and
+// RESIDENT, the decoder thread out of DECODING.
+typedef enum {
+    AUDIO_LAZY_EVICTED  = 0,      // Only the compressed bytes, decoded again on the next play
+    AUDIO_LAZY_DECODING = 1,      // Queued or being decoded, the decoder owns `vorbis` and `samples`
+    AUDIO_LAZY_DECODED  = 2,      // Handed back, published to the source on the next update
+    AUDIO_LAZY_FAILED   = 3,      // Handed back without samples
+    AUDIO_LAZY_RESIDENT = 4,      // Playable, evictable once no voice plays it
+} AudioLazyState;
+
+// Decode side of a lazy static source. It lives in the permanent arena so the decoder thread
+// can hold on to it while the AudioSource moves around the dense slot map. Sources made from
+// the same OGG bytes share one through the sample cache.
+typedef struct AudioLazySamples {
+    const uint8* data;            // Compressed OGG, must outlive the source
+    usize data_size;
+    bool owns_data;               // `data` is its own copy in the permanent arena
+    stb_vorbis* vorbis;           // Opened on play, closed by whoever finishes the decode
+    int16* samples;               // Own page mapping while decoding or resident
+    usize capacity_frames;
+    usize mapped_bytes;           // What it counts against the budget
+    usize frame_count;            // Written by the decoder before it hands the samples back
+    uint64 last_used;             // Main thread: LRU stamp, bumped on every play
+    uint32 source_count;          // Main thread: sources sharing these samples
+    uint32 voice_count;           // Main thread: voices of all of them, evictable at 0
+    _Atomic(uint32) state;        // AudioLazyState
+    _Atomic(bool) cancelled;      // Main thread: the source is going away, stop decoding it
+} AudioLazySamples;
+
 typedef struct {
     // Common fields
     AudioSourceType type;
     int channels;
     int sample_rate;
-    bool is_playing;
+    bool is_playing;              // Streaming only, static sources play through voices
     bool loop;
-    real32 volume;                // Per-source volume control
+    real32 volume;                // Per-source volume control, scales every voice of the source
+    
+    // Voice limits for static sources
+    uint8 priority;               // Voices inherit it, higher priority steals lower when the pool is full
+    uint32 max_voices;            // Concurrent voices of this source, 0 for no limit
+    uint32 voice_count;           // Voices currently playing this source
     
-    // Static audio (fully loaded)
+    // Static audio (fully loaded), immutable once created and shared by all its voices.
+    // Lazy sources only have samples while resident, voices wait while they decode.
     struct {
-        int16* samples;
+        AudioSampleFormat format;
+        int16* samples;           // AUDIO_SAMPLES_PCM16
+        const uint8* adpcm_blocks; // AUDIO_SAMPLES_ADPCM, see audio_adpcm.h
         usize sample_count;
         usize frame_count;
-        usize current_position;
+        AudioLazySamples* lazy;
     } static_data;
     
-    // Streaming audio
+    // Streaming audio, decoded ahead of the playhead by the decoder thread
     struct {
-        stb_vorbis* vorbis;
-        char* filename;           // Keep filename for reopening when looping
-        int16* stream_buffer;     // Small buffer for streaming chunks
-        usize buffer_frames;      // Size of stream buffer in frames
-        usize buffer_position;    // Current position in stream buffer
-        usize buffer_valid;       // How many frames in buffer are valid
-        bool end_of_file;         // Have we reached EOF?
+        AudioStream* stream;
+        char* filename;
     } stream_data;
 } AudioSource;
 
+// Stable reference to an AudioSource, goes stale once the source is destroyed
+typedef SlotHandle AudioSourceHandle;
+
+// One playing instance of a static source. Triggering a sound only costs a voice,
+// the PCM stays in the source.
+typedef struct {
+    AudioSourceHandle source;
+    usize position;               // Playhead in frames
+    real32 volume;                // Relative to the source volume
+    bool loop;
+    uint8 priority;
+    uint64 serial;                // Trigger order, lower is older
+} AudioVoice;
+
+// Stable reference to an AudioVoice, goes stale once the voice ends or is stolen
+typedef SlotHandle AudioVoiceHandle;
+
+// Decoded static samples, shared by every source created from the same OGG bytes
+typedef struct {
+    const int16* samples;
+    const uint8* adpcm_blocks;    // Instead of `samples` for ADPCM sources
+    usize frame_count;
+    struct AudioLazySamples* lazy; // Instead of `samples` for lazy sources, resident or not
+} AudioCachedSamples;
+
+constexpr usize AUDIO_CACHE_PATH_MAX = 256;
+
 typedef struct {
-    int16 audio[AUDIO_CAPACITY];                  // Interleaved audio samples
+    int16 audio[AUDIO_CAPACITY];                  // Interleaved output samples, clipped once per block
+    int32 bus[AUDIO_CAPACITY];                    // Unclipped mix accumulator
     usize audio_size;                             // Current size in samples
     
-    AudioSource audio_sources[MAX_AUDIO_SOURCES]; // Array of audio sources
-    usize audio_sources_size;                     // Current number of active sources
+    SLOT_MAP(AudioSource, MAX_AUDIO_SOURCES) sources; // Live sources, densely packed
+    SLOT_MAP(AudioVoice, MAX_AUDIO_VOICES) voices;    // Playing voices, densely packed
+    uint64 voice_serial;                          // Serial handed to the next voice
+
+    // Last block's mix counts, virtual voices advanced without being mixed
+    uint32 real_voice_count;
+    uint32 virtual_voice_count;
+
+    // Streaming decoder thread, the mixer never calls into stb_vorbis
+    Thread decoder_thread;
+    _Atomic(bool) decoder_should_stop;
+    _Atomic(AudioStream*) streams[MAX_AUDIO_SOURCES]; // Streams the decoder keeps filled
+    uint32 stream_starvation_count;               // Blocks any stream ran dry, since startup
+
+    // Lazy static sources, see audio_lazy_enable. Main thread only, except the request ring.
+    struct {
+        usize budget_bytes;                       // 0 while lazy loading is off
+        usize resident_bytes;                     // Mapped samples, decoding or resident
+        uint64 clock;                             // LRU stamp handed to the next play
+        uint32 pending_count;                     // Decodes not yet published
+        SpscRing requests;                        // AudioLazySamples* to decode, main produces
+        uint64 hits;                              // Plays that found samples resident or decoding
+        uint64 misses;                            // Plays that had to start a decode
+        uint64 evictions;                         // Samples unmapped to make room
+    } lazy;
+
+    AudioSampleFormat static_format;              // Format of static sources created from now on
+
+    // Decoded static samples by content hash, and where they persist between runs
+    HashMap sample_cache;                         // Key -> AudioCachedSamples*, created on first use
+    char sample_cache_directory[AUDIO_CACHE_PATH_MAX]; // Empty while the disk cache is off
 
     real32 volume;                                // Master volume control (0.0 to 1.0)
 } AudioState;
@@ -56,696 +192,1999 @@ typedef struct {
 static AudioState* audio_state;
 
 static AudioState* create_audio_state(Arena* arena) {
-    AudioState* state = (AudioState*)arena_alloc(arena, sizeof(AudioState));
+    // The lazy request ring keeps its indices on separate cache lines, see SpscRing
+    AudioState* state = (AudioState*)arena_alloc_aligned(arena, sizeof(AudioState), alignof(AudioState));
     memset(state, 0, sizeof(AudioState));
     state->volume = 1.0f;
     return state;
 }
 
-static int16* resample_audio(
-    Arena* arena,
-    int16* input_samples,
-    usize input_frames,
-    int input_channels,
-    int input_rate,
-    int target_rate,
-    usize* output_frames
-) {
-    assert(arena != nullptr);
+// Decoder thread: decodes the next chunk at the source rate and converts it into the ring
+static bool audio_stream_decode_resampled(AudioStream* stream) {
+    Resampler* resampler = &stream->resampler;
 
-    debug_print("Resampling: %d Hz -> %d Hz, %d channels, %zu frames\n", 
-        input_rate, target_rate, input_channels, input_frames);
-    
-    if (input_rate == target_rate) {
-        *output_frames = input_frames;
-        usize total_samples = input_frames * input_channels;
-        int16* output = arena_alloc(arena, total_samples * sizeof(int16));
-        memcpy(output, input_samples, total_samples * sizeof(int16));
-        return output;
+    if (!stream->flushed) {
+        int16* spans[RESAMPLER_MAX_CHANNELS];
+        usize frames = MIN(resampler_input_spans(resampler, spans), AUDIO_DECODE_CHUNK_FRAMES);
+
+        int decoded_frames = frames == 0 ? 0 : stb_vorbis_get_samples_short(
+            stream->vorbis,
+            stream->channels,
+            spans,
+            (int)frames
+        );
+
+        if (decoded_frames > 0) {
+            resampler_commit(resampler, (usize)decoded_frames);
+        } else if (frames > 0 && stream->loop) {
+            // The resampler keeps its history, so the loop point is filtered seamlessly
+            stb_vorbis_seek_start(stream->vorbis);
+        } else if (frames > 0) {
+            resampler_flush(resampler);
+            stream->flushed = true;
+        }
     }
-    
-    // If input is 22kHz and target is 48kHz, ratio should be 48/22 = 2.18 (upsample)
-    // If input is 48kHz and target is 22kHz, ratio should be 22/48 = 0.46 (downsample)
-    real64 ratio = (real64)target_rate / (real64)input_rate;
-    *output_frames = (usize)(input_frames * ratio + 0.5); // Add 0.5 for rounding
-    
-    usize output_samples = *output_frames * input_channels;
-    int16* output = arena_alloc(arena, output_samples * sizeof(int16));
-    if (!output) {
-        debug_print("Error: Transient arena out of memory for raw samples\n");
-        return nullptr;
+
+    void* span;
+    usize free_frames = spsc_ring_reserve(&stream->ring, &span);
+    usize produced = resampler_pull(resampler, (int16*)span, free_frames);
+    spsc_ring_commit(&stream->ring, produced);
+
+    if (stream->flushed && produced == 0) {
+        atomic_store(&stream->end_of_stream, true);
     }
-    
-    debug_print("Resampling ratio: %.3f, output frames: %zu\n", ratio, *output_frames);
-    
-    for (usize i = 0; i < *output_frames; i++) {
-        // For upsampling (ratio > 1): source advances slower than output
-        // For downsampling (ratio < 1): source advances faster than output
-        real64 source_index = (real64)i / ratio;
-        usize index1 = (usize)source_index;
-        usize index2 = index1 + 1;
-        
-        // Boundary check
-        if (index1 >= input_frames) index1 = input_frames - 1;
-        if (index2 >= input_frames) index2 = input_frames - 1;
-        
-        real64 fraction = source_index - (real64)index1;
-        
-        for (int ch = 0; ch < input_channels; ch++) {
-            int16 sample1 = input_samples[index1 * input_channels + ch];
-            int16 sample2 = input_samples[index2 * input_channels + ch];
-            
-            // Linear interpolation
-            real64 interpolated_d = (real64)sample1 + fraction * ((real64)sample2 - (real64)sample1);
-            int16 interpolated = (int16)CLAMP(interpolated_d, -32768.0, 32767.0);
-            
-            output[i * input_channels + ch] = interpolated;
+    return produced > 0;
+}
+
+// Decoder thread: tops up one stream's ring, returns true if it decoded anything
+static bool audio_stream_decode(AudioStream* stream) {
+    if (atomic_load(&stream->end_of_stream)) return false;
+    if (spsc_ring_count(&stream->ring) >= stream->lookahead_frames) return false;
+
+    if (stream->resample) {
+        return audio_stream_decode_resampled(stream);
+    }
+
+    void* span;
+    usize frames = MIN(spsc_ring_reserve(&stream->ring, &span), AUDIO_DECODE_CHUNK_FRAMES);
+    if (frames == 0) return false;
+
+    int decoded_frames = stb_vorbis_get_samples_short_interleaved(
+        stream->vorbis,
+        stream->channels,
+        (int16*)span,
+        (int)(frames * stream->channels)
+    );
+
+    if (decoded_frames > 0) {
+        spsc_ring_commit(&stream->ring, (usize)decoded_frames);
+        return true;
+    }
+
+    if (stream->loop) {
+        stb_vorbis_seek_start(stream->vorbis);
+    } else {
+        atomic_store(&stream->end_of_stream, true);
+    }
+    return false;
+}
+
+// Main thread: takes the stream away from the decoder, waiting out a decode in progress
+static void audio_stream_pause(AudioStream* stream) {
+    atomic_store(&stream->paused, true);
+    while (atomic_load(&stream->decoding)) {
+        thread_yield();
+    }
+}
+
+static void audio_stream_restart(AudioStream* stream) {
+    audio_stream_pause(stream);
+
+    stb_vorbis_seek_start(stream->vorbis);
+    spsc_ring_reset(&stream->ring);
+    if (stream->resample) {
+        resampler_reset(&stream->resampler);
+    }
+    stream->flushed = false;
+    stream->started = false;
+    atomic_store(&stream->end_of_stream, false);
+
+    atomic_store(&stream->paused, false);
+}
+
+// Mixes one block of a voice, returns false once the voice has finished
+static bool process_audio_voice(
+    AudioVoice* voice,
+    AudioSource* source,
+    AudioState* audio_state,
+    usize frames_needed
+) {
+    assert(voice != nullptr && source != nullptr);
+    assert(source->channels == (int)AUDIO_CHANNELS && "Static samples are converted at load");
+
+    int32 gain = audio_gain_q15(source->volume * voice->volume);
+    usize frames_processed = 0;
+
+    // Mix in contiguous runs up to the end of the sample, wrapping when looping
+    while (frames_processed < frames_needed) {
+        if (voice->position >= source->static_data.frame_count) {
+            if (!voice->loop || source->static_data.frame_count == 0) {
+                return false;
+            }
+            voice->position = 0;
         }
+
+        usize frames_available = source->static_data.frame_count - voice->position;
+        usize frames_to_process = MIN(frames_needed - frames_processed, frames_available);
+        const int16* src;
+
+        // ADPCM runs stop at block ends, each block is decoded up to where the run ends
+        int16 block[AUDIO_ADPCM_BLOCK_FRAMES * AUDIO_CHANNELS];
+        if (source->static_data.format == AUDIO_SAMPLES_PCM16) {
+            src = source->static_data.samples + voice->position * AUDIO_CHANNELS;
+        } else {
+            usize block_index = voice->position / AUDIO_ADPCM_BLOCK_FRAMES;
+            usize offset = voice->position % AUDIO_ADPCM_BLOCK_FRAMES;
+            frames_to_process = MIN(frames_to_process, AUDIO_ADPCM_BLOCK_FRAMES - offset);
+
+            audio_adpcm_decode_block(
+                block,
+                source->static_data.adpcm_blocks + block_index * audio_adpcm_block_bytes(AUDIO_CHANNELS),
+                offset + frames_to_process,
+                AUDIO_CHANNELS
+            );
+            src = block + offset * AUDIO_CHANNELS;
+        }
+
+        mix_s16(
+            audio_state->bus + frames_processed * AUDIO_CHANNELS,
+            src,
+            frames_to_process * AUDIO_CHANNELS,
+            gain
+        );
+
+        voice->position += frames_to_process;
+        frames_processed += frames_to_process;
     }
+
+    return voice->position < source->static_data.frame_count || voice->loop;
+}
+
+// Advances an inaudible voice's playhead by a block without mixing it, so it resumes in
+// place once it becomes audible again. Returns false once the voice has finished.
+static bool advance_virtual_audio_voice(AudioVoice* voice, AudioSource* source, usize frames_needed) {
+    usize frame_count = source->static_data.frame_count;
+
+    voice->position += frames_needed;
+    if (voice->position < frame_count) return true;
+    if (!voice->loop || frame_count == 0) return false;
+
+    voice->position %= frame_count;
+    return true;
+}
+
+static void process_streaming_audio_source(
+    AudioSource* source,
+    AudioState* audio_state,
+    usize frames_needed,
+    bool audible
+) {
+    assert(source != nullptr);
+    AudioStream* stream = source->stream_data.stream;
+    int32 gain = audio_gain_q15(source->volume);
+    usize frames_processed = 0;
     
-    return output;
+    while (frames_processed < frames_needed) {
+        const void* span;
+        usize frames_available = spsc_ring_peek(&stream->ring, &span);
+
+        if (frames_available == 0) {
+            // The decoder publishes its last frames before flagging the end, so frames that
+            // landed between the peek and the flag still get played
+            bool finished = atomic_load(&stream->end_of_stream);
+            if (finished && spsc_ring_count(&stream->ring) > 0) continue;
+
+            if (finished) {
+                source->is_playing = false;
+            } else if (stream->started) {
+                // Before its first frames the decoder simply has not had a turn yet
+                stream->starved_blocks++;
+                audio_state->stream_starvation_count++;
+            }
+            break;
+        }
+
+        stream->started = true;
+        usize frames_to_process = MIN(frames_needed - frames_processed, frames_available);
+
+        int32* dst = audio_state->bus + frames_processed * AUDIO_CHANNELS;
+        const int16* src = (const int16*)span;
+
+        // The ring is already at AUDIO_SAMPLE_RATE. Inaudible streams still consume their
+        // frames to keep the timeline moving.
+        if (audible && source->channels == (int)AUDIO_CHANNELS) {
+            mix_s16(dst, src, frames_to_process * AUDIO_CHANNELS, gain);
+        } else if (audible && source->channels == 1 && AUDIO_CHANNELS == 2) {
+            mix_s16_mono_to_stereo(dst, src, frames_to_process, gain);
+        }
+        
+        spsc_ring_consume(&stream->ring, frames_to_process);
+        frames_processed += frames_to_process;
+    }
+}
+
+// Resampling quality for static sources, paid once at load
+constexpr ResampleQuality AUDIO_STATIC_RESAMPLE_QUALITY = RESAMPLE_LINEAR;
+
+// Frames to allocate for the stream once decoded to AUDIO_SAMPLE_RATE, 0 if its length is
+// unknown. Converted lengths round to the nearest frame, as resample_output_frames.
+static usize audio_decoded_capacity(stb_vorbis* vorbis) {
+    stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+    usize total_frames = stb_vorbis_stream_length_in_samples(vorbis);
+    if (total_frames == 0 || info.sample_rate == (uint32)AUDIO_SAMPLE_RATE) return total_frames;
+
+    return resample_output_frames(total_frames, (int)info.sample_rate, (int)AUDIO_SAMPLE_RATE);
 }
 
-// Channel conversion helper
-static void convert_channels(
-    int16* input,
-    int input_channels,
+// Resumable decode of output frames [first, first + count), see audio_decode_vorbis_range
+typedef struct {
+    stb_vorbis* vorbis;
+    int16* output;                // Frame `first` of the stream's buffer
+    usize count;
+    usize written;
+    bool resample;
+    bool flushed;                 // The end of the input was pushed into the resampler
+    Resampler resampler;
+} AudioRangeDecoder;
+
+static bool audio_range_decoder_init(
+    AudioRangeDecoder* decoder,
+    stb_vorbis* vorbis,
+    Arena* scratch,
     int16* output,
-    int output_channels,
-    usize frames
+    usize first,
+    usize count
 ) {
-    for (usize frame = 0; frame < frames; frame++) {
-        if (input_channels == 1 && output_channels == 2) {
-            // Mono to stereo
-            int16 mono = input[frame];
-            output[frame * 2 + 0] = mono;
-            output[frame * 2 + 1] = mono;
-        } else if (input_channels == 2 && output_channels == 1) {
-            // Stereo to mono
-            int16 left = input[frame * 2 + 0];
-            int16 right = input[frame * 2 + 1];
-            output[frame] = (int16)((left + right) / 2);
+    stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+    *decoder = (AudioRangeDecoder){
+        .vorbis = vorbis,
+        .output = output + first * AUDIO_CHANNELS,
+        .count = count,
+        .resample = info.sample_rate != (uint32)AUDIO_SAMPLE_RATE,
+    };
+
+    if (!decoder->resample) {
+        return first == 0 || stb_vorbis_seek(vorbis, (unsigned int)first);
+    }
+
+    Resampler* resampler = &decoder->resampler;
+    if (!resampler_init(
+        resampler,
+        scratch,
+        (int)AUDIO_CHANNELS,
+        (int)info.sample_rate,
+        (int)AUDIO_SAMPLE_RATE,
+        AUDIO_STATIC_RESAMPLE_QUALITY,
+        AUDIO_DECODE_CHUNK_FRAMES
+    )) {
+        return false;
+    }
+
+    if (first > 0) {
+        // Linear has no filter history, so the first input frame the range reads is the
+        // first one it needs and the fractional position carries over exactly
+        assert(resampler->taps_before == 0 && "Range decoding needs a resampler without history");
+        uint64 position = (uint64)first * resampler->step;
+        if (!stb_vorbis_seek(vorbis, (unsigned int)(position >> 32))) return false;
+        resampler->position = position & 0xFFFFFFFFull;
+    }
+    return true;
+}
+
+// Decodes up to `max_frames` of the range's next frames into `dst`, at most one chunk of
+// input per call. Returns the frames written, 0 once the range is complete or the stream ended.
+static usize audio_range_decoder_read(AudioRangeDecoder* decoder, int16* dst, usize max_frames) {
+    max_frames = MIN(max_frames, decoder->count - decoder->written);
+    if (max_frames == 0) return 0;
+
+    if (!decoder->resample) {
+        usize frames = MIN(max_frames, AUDIO_DECODE_CHUNK_FRAMES);
+        int decoded_frames = stb_vorbis_get_samples_short_interleaved(
+            decoder->vorbis,
+            (int)AUDIO_CHANNELS,
+            dst,
+            (int)(frames * AUDIO_CHANNELS)
+        );
+        if (decoded_frames <= 0) return 0;
+
+        decoder->written += (usize)decoded_frames;
+        return (usize)decoded_frames;
+    }
+
+    Resampler* resampler = &decoder->resampler;
+    for (;;) {
+        usize produced = resampler_pull(resampler, dst, max_frames);
+        decoder->written += produced;
+        if (produced > 0 || decoder->flushed) return produced;
+
+        int16* spans[RESAMPLER_MAX_CHANNELS];
+        usize frames = MIN(resampler_input_spans(resampler, spans), AUDIO_DECODE_CHUNK_FRAMES);
+        assert(frames > 0 && "A full resampler always has output");
+
+        int decoded_frames = stb_vorbis_get_samples_short(
+            decoder->vorbis,
+            (int)AUDIO_CHANNELS,
+            spans,
+            (int)frames
+        );
+
+        if (decoded_frames > 0) {
+            resampler_commit(resampler, (usize)decoded_frames);
         } else {
-            // Direct copy or take first available channels
-            for (int ch = 0; ch < output_channels; ch++) {
-                int src_ch = (ch < input_channels) ? ch : 0;
-                output[frame * output_channels + ch] = input[frame * input_channels + src_ch];
+            resampler_flush(resampler);
+            decoder->flushed = true;
+        }
+    }
+}
+
+// Decodes the next chunk of the range in place, returns false once it is complete or the stream ended
+static bool audio_range_decoder_step(AudioRangeDecoder* decoder) {
+    int16* dst = decoder->output + decoder->written * AUDIO_CHANNELS;
+    usize frames = audio_range_decoder_read(decoder, dst, AUDIO_DECODE_CHUNK_FRAMES);
+    return frames > 0 && decoder->written < decoder->count;
+}
+
+/**
+ * @brief Decodes output frames [first, first + count) of a stream into `output` (the whole
+ * stream's buffer) at AUDIO_SAMPLE_RATE / AUDIO_CHANNELS, one chunk at a time. stb_vorbis
+ * converts channels as it decodes, the resampler converts the rate, and every frame is
+ * written once, straight into place. Scratch is O(chunk), taken from `scratch`.
+ *
+ * A range that starts past 0 seeks there first. Output frame i always reads input position
+ * i * step, so decoding the stream in ranges is bit-identical to decoding it in one go.
+ * Returns the frames written, fewer than `count` when the stream ends first.
+ */
+static usize audio_decode_vorbis_range(stb_vorbis* vorbis, Arena* scratch, int16* output, usize first, usize count) {
+    AudioRangeDecoder decoder;
+    if (!audio_range_decoder_init(&decoder, vorbis, scratch, output, first, count)) return 0;
+
+    while (audio_range_decoder_step(&decoder)) {}
+    return decoder.written;
+}
+
+// Decoder thread: the lazy source it is decoding, one chunk per pass over the streams
+typedef struct {
+    AudioLazySamples* lazy;
+    AudioRangeDecoder decoder;
+    ArenaTemp scratch;
+} AudioLazyDecode;
+
+// Decoder thread: closes the decode and hands the samples back to the main thread
+static void audio_lazy_decode_finish(AudioLazyDecode* decode, bool decoded) {
+    AudioLazySamples* lazy = decode->lazy;
+    stb_vorbis_close(lazy->vorbis);
+    lazy->vorbis = nullptr;
+    lazy->frame_count = decoded ? decode->decoder.written : 0;
+    scratch_end(decode->scratch);
+
+    atomic_store_explicit(&lazy->state, decoded ? AUDIO_LAZY_DECODED : AUDIO_LAZY_FAILED, memory_order_release);
+    decode->lazy = nullptr;
+}
+
+// Decoder thread: advances the current lazy decode by a chunk, or picks up the next request.
+// Returns true if it did any work.
+static bool audio_lazy_decode_step(AudioState* audio_state, AudioLazyDecode* decode) {
+    if (!decode->lazy) {
+        const void* span;
+        if (spsc_ring_peek(&audio_state->lazy.requests, &span) == 0) return false;
+        decode->lazy = *(AudioLazySamples* const*)span;
+        spsc_ring_consume(&audio_state->lazy.requests, 1);
+
+        // Only decodes, never opens or seeks: those touch stb_vorbis' global CRC table,
+        // which the main thread may be rewriting
+        AudioLazySamples* lazy = decode->lazy;
+        decode->scratch = scratch_begin(nullptr, 0);
+        if (!audio_range_decoder_init(&decode->decoder, lazy->vorbis, decode->scratch.arena, lazy->samples, 0, lazy->capacity_frames)) {
+            audio_lazy_decode_finish(decode, false);
+            return true;
+        }
+    }
+
+    if (atomic_load(&decode->lazy->cancelled)) {
+        audio_lazy_decode_finish(decode, false);
+    } else if (!audio_range_decoder_step(&decode->decoder)) {
+        audio_lazy_decode_finish(decode, decode->decoder.written > 0);
+    }
+    return true;
+}
+
+static void audio_decoder_thread_proc(void* data) {
+    AudioState* audio_state = (AudioState*)data;
+    AudioLazyDecode lazy_decode = {};
+
+    while (!atomic_load(&audio_state->decoder_should_stop)) {
+        bool did_work = false;
+
+        for (usize i = 0; i < MAX_AUDIO_SOURCES; i++) {
+            AudioStream* stream = atomic_load(&audio_state->streams[i]);
+            if (!stream) continue;
+
+            // Pairs with audio_stream_pause: either we see `paused`, or it waits for us
+            atomic_store(&stream->decoding, true);
+            if (!atomic_load(&stream->paused)) {
+                did_work |= audio_stream_decode(stream);
             }
+            atomic_store(&stream->decoding, false);
+        }
+
+        // Lazy sources get one chunk per pass, so a long one never starves the streams
+        did_work |= audio_lazy_decode_step(audio_state, &lazy_decode);
+
+        if (!did_work) {
+            sleep_nanos(AUDIO_DECODER_IDLE_MS * NANOS_PER_MILLI);
+        }
+    }
+
+    // An unfinished lazy decode is handed back, it starts over on the next play
+    if (lazy_decode.lazy) {
+        audio_lazy_decode_finish(&lazy_decode, false);
+    }
+    scratch_thread_cleanup();
+}
+
+/**
+ * @brief Starts the thread that decodes streaming sources ahead of the mixer, and lazy
+ * static sources on their first play.
+ */
+bool audio_decoder_start(AudioState* audio_state) {
+    atomic_store(&audio_state->decoder_should_stop, false);
+    return thread_create(&audio_state->decoder_thread, audio_decoder_thread_proc, audio_state);
+}
+
+void audio_decoder_stop(AudioState* audio_state) {
+    atomic_store(&audio_state->decoder_should_stop, true);
+    thread_join(&audio_state->decoder_thread);
+
+    // Lazy decodes still queued are failed back to the main thread, see audio_lazy_update
+    const void* span;
+    while (spsc_ring_peek(&audio_state->lazy.requests, &span) > 0) {
+        AudioLazySamples* lazy = *(AudioLazySamples* const*)span;
+        spsc_ring_consume(&audio_state->lazy.requests, 1);
+
+        stb_vorbis_close(lazy->vorbis);
+        lazy->vorbis = nullptr;
+        atomic_store(&lazy->state, AUDIO_LAZY_FAILED);
+    }
+}
+
+// One asset to load. Fill in the input, batch loads fill in the handle.
+typedef struct {
+    const char* filename;         // OGG file to load, ignored when `data` is set
+    const uint8* data;            // OGG in memory, e.g. #embed
+    usize data_size;
+    bool loop;
+
+    AudioSourceHandle handle;     // Null if the asset failed to load
+} AudioLoadRequest;
+
+static stb_vorbis* audio_load_request_open(const AudioLoadRequest* request) {
+    int error = 0;
+    stb_vorbis* vorbis = nullptr;
+
+    if (request->data) {
+        if (request->data_size <= INT_MAX) {
+            vorbis = stb_vorbis_open_memory(request->data, (int)request->data_size, &error, nullptr);
         }
+        if (!vorbis) debug_print("Error: Could not open OGG data in memory (error: %d)\n", error);
+    } else {
+        vorbis = stb_vorbis_open_filename(request->filename, &error, nullptr);
+        if (!vorbis) debug_print("Error: Could not open OGG file '%s' (error: %d)\n", request->filename, error);
     }
+    return vorbis;
+}
+
+// Frames each range decodes at least, shorter ranges would spend more time seeking than decoding
+constexpr usize AUDIO_DECODE_MIN_RANGE_FRAMES = AUDIO_SAMPLE_RATE * 10;
+
+// `decode_ranges` values: one range on the calling thread, or one per hardware thread
+constexpr uint32 AUDIO_DECODE_RANGES_SERIAL = 1;
+constexpr uint32 AUDIO_DECODE_RANGES_AUTO = 0;
+
+typedef struct {
+    stb_vorbis** decoders;        // One per range, each range seeks its own
+    int16* samples;
+    usize capacity_frames;
+    usize range_count;
+    usize* decoded_frames;        // Per range
+} AudioDecodeRanges;
+
+static inline usize audio_decode_range_first(AudioDecodeRanges* ranges, usize range) {
+    return ranges->capacity_frames * range / ranges->range_count;
 }
 
-static void audio_source_stream_begin(AudioSource* source) {
-    assert(source->type == AUDIO_SOURCE_STREAMING 
-           && "tried to start stream source of a non-streaming audio source");
-    stb_vorbis_seek_start(source->stream_data.vorbis);
+static void audio_decode_range_job(void* data, usize range) {
+    AudioDecodeRanges* ranges = (AudioDecodeRanges*)data;
+    usize first = audio_decode_range_first(ranges, range);
+    usize count = audio_decode_range_first(ranges, range + 1) - first;
+
+    ArenaTemp scratch = scratch_begin(nullptr, 0);
+    ranges->decoded_frames[range] = audio_decode_vorbis_range(
+        ranges->decoders[range], scratch.arena, ranges->samples, first, count);
+    scratch_end(scratch);
 }
 
-static void audio_source_stream_end(AudioSource* source) {
-    assert(source->type == AUDIO_SOURCE_STREAMING 
-           && "tried to close stream source of a non-streaming audio source");
-    stb_vorbis_close(source->stream_data.vorbis);
+// Splits the stream into `range_count` ranges decoded in parallel, each with its own decoder
+// opened here: stb_vorbis rewrites a global CRC table on every open, so opens stay on the
+// calling thread while the jobs only seek and decode. Returns the frames decoded, 0 on failure.
+static usize audio_decode_vorbis_ranges(
+    Arena* transient_storage,
+    const AudioLoadRequest* request,
+    stb_vorbis* vorbis,
+    int16* samples,
+    usize capacity_frames,
+    usize range_count
+) {
+    AudioDecodeRanges ranges = {
+        .decoders = arena_alloc(transient_storage, range_count * sizeof(stb_vorbis*)),
+        .samples = samples,
+        .capacity_frames = capacity_frames,
+        .range_count = range_count,
+        .decoded_frames = arena_alloc(transient_storage, range_count * sizeof(usize)),
+    };
+    if (!ranges.decoders || !ranges.decoded_frames) {
+        debug_print("Error: Transient arena out of memory for decode ranges\n");
+        return 0;
+    }
+
+    ranges.decoders[0] = vorbis;
+    usize opened = 1;
+    for (; opened < range_count; opened++) {
+        ranges.decoders[opened] = audio_load_request_open(request);
+        if (!ranges.decoders[opened]) break;
+    }
+
+    usize frame_count = 0;
+    if (opened == range_count) {
+        job_run(audio_decode_range_job, &ranges, range_count);
+
+        // Every range but the last must be complete, the last one ends with the stream
+        usize last = range_count - 1;
+        bool complete = true;
+        for (usize i = 0; i < last; i++) {
+            usize expected = audio_decode_range_first(&ranges, i + 1) - audio_decode_range_first(&ranges, i);
+            complete &= ranges.decoded_frames[i] == expected;
+        }
+        if (complete) {
+            frame_count = audio_decode_range_first(&ranges, last) + ranges.decoded_frames[last];
+        }
+    }
+
+    // The caller closes the first decoder
+    for (usize i = 1; i < opened; i++) {
+        stb_vorbis_close(ranges.decoders[i]);
+    }
+    return frame_count;
 }
 
-static bool audio_source_stream_refill_buffer(AudioSource* source) {
-    if (source->type != AUDIO_SOURCE_STREAMING || !source->stream_data.vorbis) {
+// Cooked sound container, written by tools/cook_audio.c (`make cook`) and by the disk sample
+// cache: this header, then frame_count * channels int16 samples at data_offset, already at
+// the mixer's format. Fields and samples are little-endian.
+constexpr uint32 AUDIO_COOKED_MAGIC = 0x444E5343;          // "CSND"
+constexpr uint32 AUDIO_COOKED_VERSION = 3;
+constexpr uint32 AUDIO_COOKED_DATA_OFFSET = 64;            // Keeps the samples aligned for the mixer
+
+typedef struct {
+    uint32 magic;
+    uint32 version;
+    uint32 sample_rate;
+    uint32 channels;
+    uint64 frame_count;
+    uint32 data_offset;
+    uint32 reserved;
+    uint64 source_hash;           // audio_sample_cache_key of the OGG it was decoded from
+} AudioCookedHeader;
+
+static_assert(sizeof(AudioCookedHeader) <= AUDIO_COOKED_DATA_OFFSET, "Cooked header overlaps the samples");
+
+// Checks a cooked header against this version and the mixer's format
+static bool audio_cooked_header_valid(const AudioCookedHeader* header) {
+    if (header->magic != AUDIO_COOKED_MAGIC || header->version != AUDIO_COOKED_VERSION) {
+        debug_print("Error: Not a cooked sound, or cooked by another version\n");
         return false;
     }
-    
-    // Read more data from the OGG file
-    int samples_read = stb_vorbis_get_samples_short_interleaved(
-        source->stream_data.vorbis,
-        source->channels,
-        source->stream_data.stream_buffer,
-        (int)(source->stream_data.buffer_frames * source->channels)
-    );
-    
-    if (samples_read > 0) {
-        source->stream_data.buffer_valid = (usize)samples_read;
-        source->stream_data.buffer_position = 0;
-        source->stream_data.end_of_file = false;
-        return true;
-    } else {
-        // End of file reached
-        source->stream_data.end_of_file = true;
-        
-        if (source->loop) {
-            // Restart the file
-            stb_vorbis_seek_start(source->stream_data.vorbis);
-            return audio_source_stream_refill_buffer(source); // Try again
+
+    // Cooked for another build configuration, `make cook` again
+    if (header->sample_rate != (uint32)AUDIO_SAMPLE_RATE || header->channels != (uint32)AUDIO_CHANNELS) {
+        debug_print("Error: Cooked sound is %u Hz, %u channels, expected %d Hz, %d channels\n",
+            header->sample_rate, header->channels, AUDIO_SAMPLE_RATE, AUDIO_CHANNELS);
+        return false;
+    }
+
+    return header->data_offset >= sizeof(AudioCookedHeader);
+}
+
+// Validates a cooked sound in memory and finds its samples
+static bool audio_cooked_parse(const uint8* data, usize data_size, AudioCookedHeader* header, const int16** samples) {
+    if (data_size < sizeof(*header)) {
+        debug_print("Error: Cooked sound is too small for its header\n");
+        return false;
+    }
+    memcpy(header, data, sizeof(*header));
+    if (!audio_cooked_header_valid(header)) return false;
+
+    usize sample_count = (usize)header->frame_count * AUDIO_CHANNELS;
+    if (header->data_offset > data_size || sample_count > (data_size - header->data_offset) / sizeof(int16)) {
+        debug_print("Error: Cooked sound is truncated\n");
+        return false;
+    }
+
+    *samples = (const int16*)(data + header->data_offset);
+    assert((uintptr_t)*samples % alignof(int16) == 0 && "Cooked samples must be aligned");
+    return true;
+}
+
+/**
+ * @brief Writes samples at the mixer's format as a cooked sound.
+ */
+bool audio_cooked_write(const char* path, uint64 source_hash, const int16* samples, usize frame_count) {
+    AudioCookedHeader header = {
+        .magic = AUDIO_COOKED_MAGIC,
+        .version = AUDIO_COOKED_VERSION,
+        .sample_rate = (uint32)AUDIO_SAMPLE_RATE,
+        .channels = (uint32)AUDIO_CHANNELS,
+        .frame_count = frame_count,
+        .data_offset = AUDIO_COOKED_DATA_OFFSET,
+        .source_hash = source_hash,
+    };
+    uint8 padding[AUDIO_COOKED_DATA_OFFSET - sizeof(AudioCookedHeader)] = {};
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        debug_print("Error: Could not create '%s'\n", path);
+        return false;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(padding, sizeof(padding), 1, file) == 1 &&
+                   fwrite(samples, sizeof(int16) * AUDIO_CHANNELS, frame_count, file) == frame_count;
+    written &= fclose(file) == 0;
+
+    if (!written) {
+        debug_print("Error: Failed to write '%s'\n", path);
+        remove(path);
+    }
+    return written;
+}
+
+// Reads a whole file into the arena, nullptr if it cannot be read. Meant for transient
+// arenas, whose scope releases the buffer either way.
+static uint8* audio_read_file(Arena* arena, const char* path, usize* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return nullptr;
+
+    uint8* data = nullptr;
+    long length = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    if (length > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = arena_alloc(arena, (usize)length);
+        if (data && fread(data, 1, (usize)length, file) == (usize)length) {
+            *size = (usize)length;
+        } else {
+            data = nullptr;
         }
-        
+    }
+
+    fclose(file);
+    return data;
+}
+
+// Identifies decoded samples: the OGG bytes plus everything that shapes the decode
+static uint64 audio_sample_cache_key(const uint8* data, usize data_size, AudioSampleFormat sample_format) {
+    uint64 format = ((uint64)AUDIO_SAMPLE_RATE << 32) |
+                    ((uint64)AUDIO_CHANNELS << 16) |
+                    ((uint64)sample_format << 8) |
+                    (uint64)AUDIO_STATIC_RESAMPLE_QUALITY;
+    return hash_mix(hash_bytes(data, data_size) ^ hash_mix(format));
+}
+
+static AudioCachedSamples* audio_sample_cache_get(AudioState* audio_state, uint64 key) {
+    uint64 value;
+    if (!audio_state->sample_cache.entries || !hash_map_get(&audio_state->sample_cache, hash_key_id(key), &value)) {
+        return nullptr;
+    }
+    return (AudioCachedSamples*)(uintptr_t)value;
+}
+
+static AudioCachedSamples* audio_sample_cache_put(
+    Arena* permanent_storage,
+    AudioState* audio_state,
+    uint64 key,
+    const int16* samples,
+    usize frame_count
+) {
+    if (!audio_state->sample_cache.entries) {
+        audio_state->sample_cache = create_hash_map(permanent_storage, MAX_AUDIO_SOURCES);
+        if (!audio_state->sample_cache.entries) return nullptr;
+    }
+
+    AudioCachedSamples* cached = arena_alloc(permanent_storage, sizeof(AudioCachedSamples));
+    if (!cached) return nullptr;
+    *cached = (AudioCachedSamples){ .samples = samples, .frame_count = frame_count };
+
+    if (!hash_map_put(&audio_state->sample_cache, hash_key_id(key), (uint64)(uintptr_t)cached)) {
+        return nullptr;
+    }
+    return cached;
+}
+
+static void audio_sample_cache_path(AudioState* audio_state, uint64 key, char* path, usize path_size) {
+    snprintf(path, path_size, "%s/%016llx.pcm", audio_state->sample_cache_directory, (unsigned long long)key);
+}
+
+// Looks the samples up in memory, then on disk when the disk cache is enabled. A file whose
+// header does not match the key (stale, corrupt, other format) is ignored and rewritten later.
+static AudioCachedSamples* audio_sample_cache_find(Arena* permanent_storage, AudioState* audio_state, uint64 key) {
+    AudioCachedSamples* cached = audio_sample_cache_get(audio_state, key);
+    // Lazy samples come and go, callers here need them resident for good
+    if (cached && cached->lazy) cached = nullptr;
+    if (cached || audio_state->sample_cache_directory[0] == '\0') return cached;
+
+    char path[AUDIO_CACHE_PATH_MAX + 32];
+    audio_sample_cache_path(audio_state, key, path, sizeof(path));
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return nullptr;
+
+    // The header and file size are checked before anything is allocated, the samples go
+    // straight to their permanent place
+    AudioCookedHeader header;
+    usize sample_count = 0;
+    long file_size = -1;
+    if (fread(&header, sizeof(header), 1, file) == 1 && audio_cooked_header_valid(&header) && header.source_hash == key) {
+        sample_count = (usize)header.frame_count * AUDIO_CHANNELS;
+        file_size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    }
+
+    if (sample_count > 0 &&
+        file_size >= 0 &&
+        (usize)file_size - MIN((usize)file_size, header.data_offset) >= sample_count * sizeof(int16) &&
+        fseek(file, (long)header.data_offset, SEEK_SET) == 0) {
+        int16* samples = arena_alloc(permanent_storage, sample_count * sizeof(int16));
+
+        if (samples && fread(samples, sizeof(int16), sample_count, file) == sample_count) {
+            cached = audio_sample_cache_put(permanent_storage, audio_state, key, samples, (usize)header.frame_count);
+            debug_print("  Loaded decoded samples from the disk cache: %s\n", path);
+        }
+    }
+
+    fclose(file);
+    return cached;
+}
+
+// Persists freshly decoded samples when the disk cache is enabled, failures only cost a re-decode
+static void audio_sample_cache_store(AudioState* audio_state, uint64 key, const int16* samples, usize frame_count) {
+    if (audio_state->sample_cache_directory[0] == '\0') return;
+
+    char path[AUDIO_CACHE_PATH_MAX + 32];
+    audio_sample_cache_path(audio_state, key, path, sizeof(path));
+    audio_cooked_write(path, key, samples, frame_count);
+}
+
+static bool audio_make_directories(char* path) {
+    // Creates each parent in turn, `path` is restored as it goes. Only the last one has to
+    // succeed, parents may be drive roots or directories we cannot write to.
+    for (char* c = path + 1; ; c++) {
+        if (*c != '/' && *c != '\\' && *c != '\0') continue;
+
+        char separator = *c;
+        *c = '\0';
+#ifdef _WIN32
+        bool created = CreateDirectoryA(path, nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+        bool created = mkdir(path, 0755) == 0 || errno == EEXIST;
+#endif
+        *c = separator;
+
+        if (separator == '\0') return created;
+    }
+}
+
+/**
+ * @brief Persists decoded static samples under `directory` (nullptr for the per-user cache
+ * directory, e.g. ~/.cache/c-celeste-clone/audio), so later launches skip decoding.
+ * Files are named by content hash, a changed OGG simply gets a new file.
+ */
+bool audio_sample_cache_enable_disk(AudioState* audio_state, const char* directory) {
+    char* path = audio_state->sample_cache_directory;
+    int length;
+
+    if (directory) {
+        length = snprintf(path, AUDIO_CACHE_PATH_MAX, "%s", directory);
+    } else {
+#ifdef _WIN32
+        const char* base = getenv("LOCALAPPDATA");
+        length = snprintf(path, AUDIO_CACHE_PATH_MAX, "%s\\c-celeste-clone\\audio", base ? base : ".");
+#else
+        const char* xdg = getenv("XDG_CACHE_HOME");
+        const char* home = getenv("HOME");
+        length = xdg && xdg[0]
+            ? snprintf(path, AUDIO_CACHE_PATH_MAX, "%s/c-celeste-clone/audio", xdg)
+            : snprintf(path, AUDIO_CACHE_PATH_MAX, "%s/.cache/c-celeste-clone/audio", home ? home : ".");
+#endif
+    }
+
+    if (length <= 0 || length >= (int)AUDIO_CACHE_PATH_MAX || !audio_make_directories(path)) {
+        debug_print("Error: Could not use '%s' as the audio cache directory\n", path);
+        path[0] = '\0';
         return false;
     }
+
+    debug_print("Audio disk cache: %s\n", path);
+    return true;
 }
 
-static void process_static_audio_source(AudioSource* source, AudioState* audio_state, usize frames_needed) {
-    assert(source != nullptr);
+static AudioSourceHandle audio_source_insert_static(
+    AudioState* audio_state,
+    const int16* samples,
+    usize frame_count,
+    bool loop
+) {
+    if (slot_map_is_full(audio_state->sources)) {
+        debug_print("Error: Maximum audio sources reached\n");
+        return (AudioSourceHandle){};
+    }
 
-    for (usize frame = 0; frame < frames_needed; frame++) {
-        if (source->static_data.current_position >= source->static_data.frame_count) {
-            if (source->loop) {
-                source->static_data.current_position = 0;
-            } else {
-                source->is_playing = false;
-                break;
-            }
+    AudioSource source = {
+        .type = AUDIO_SOURCE_STATIC,
+        .channels = (int)AUDIO_CHANNELS,
+        .sample_rate = (int)AUDIO_SAMPLE_RATE,
+        .loop = loop,
+        .volume = 1.0f,
+        .static_data = {
+            // The mixer only reads static samples, they can be shared or live in read-only data
+            .samples = (int16*)samples,
+            .sample_count = frame_count * AUDIO_CHANNELS,
+            .frame_count = frame_count,
+        },
+    };
+    return slot_map_insert(audio_state->sources, source);
+}
+
+static AudioSourceHandle audio_source_insert_adpcm(
+    AudioState* audio_state,
+    const uint8* adpcm_blocks,
+    usize frame_count,
+    bool loop
+) {
+    AudioSourceHandle handle = audio_source_insert_static(audio_state, nullptr, frame_count, loop);
+    AudioSource* source = slot_map_get(audio_state->sources, handle);
+    if (source) {
+        source->static_data.format = AUDIO_SAMPLES_ADPCM;
+        source->static_data.adpcm_blocks = adpcm_blocks;
+    }
+    return handle;
+}
+
+// Decodes an OGG straight into ADPCM blocks: a chunk of PCM at a time goes through a
+// transient window and is encoded, so the whole stream never exists as PCM. Returns the
+// frames encoded, 0 on failure.
+static usize audio_decode_vorbis_adpcm(stb_vorbis* vorbis, Arena* scratch, uint8* blocks, usize capacity_frames) {
+    static_assert(AUDIO_DECODE_CHUNK_FRAMES % AUDIO_ADPCM_BLOCK_FRAMES == 0, "Windows must hold whole blocks");
+    int16* window = arena_alloc(scratch, AUDIO_DECODE_CHUNK_FRAMES * AUDIO_CHANNELS * sizeof(int16));
+    AudioRangeDecoder decoder;
+    if (!window || !audio_range_decoder_init(&decoder, vorbis, scratch, window, 0, capacity_frames)) return 0;
+
+    AudioAdpcmEncoder encoder = {};
+    usize block_bytes = audio_adpcm_block_bytes(AUDIO_CHANNELS);
+    usize frame_count = 0;
+    usize buffered = 0;
+    for (;;) {
+        usize frames = audio_range_decoder_read(
+            &decoder, window + buffered * AUDIO_CHANNELS, AUDIO_DECODE_CHUNK_FRAMES - buffered);
+        buffered += frames;
+
+        // Only the last window can end inside a block
+        if (buffered == AUDIO_DECODE_CHUNK_FRAMES || (frames == 0 && buffered > 0)) {
+            uint8* dst = blocks + frame_count / AUDIO_ADPCM_BLOCK_FRAMES * block_bytes;
+            audio_adpcm_encode_blocks(&encoder, dst, window, buffered, AUDIO_CHANNELS);
+            frame_count += buffered;
+            buffered = 0;
         }
-        
-        for (usize ch = 0; ch < AUDIO_CHANNELS; ch++) {
-            usize src_idx = source->static_data.current_position * source->channels + ch;
-            usize dst_idx = frame * AUDIO_CHANNELS + ch;
-            
-            int mixed = (int)audio_state->audio[dst_idx] + 
-                       (int)(source->static_data.samples[src_idx] * source->volume);
-            
-            audio_state->audio[dst_idx] = (int16)CLAMP(mixed, -32768, 32767);
+        if (frames == 0) return frame_count;
+    }
+}
+
+// Decodes an OGG in memory into the permanent arena and caches the result under `cache_key`.
+// PCM16 can be split into `decode_ranges` parallel ranges (AUDIO_DECODE_RANGES_AUTO picks one
+// per hardware thread),
+// ADPCM encodes while it decodes and always runs on the calling thread.
+static AudioSourceHandle create_audio_source_static_decoded(
+    Arena* permanent_storage,
+    Arena* transient_storage,
+    AudioState* audio_state,
+    const AudioLoadRequest* request,
+    uint64 cache_key,
+    uint32 decode_ranges
+) {
+    AudioSourceHandle handle = {};
+    stb_vorbis* vorbis = audio_load_request_open(request);
+    if (!vorbis) return handle;
+
+    // Resampler scratch and the ADPCM window are borrowed from the transient arena and
+    // released on exit
+    ArenaTemp temp = arena_temp_begin(transient_storage);
+    bool adpcm = audio_state->static_format == AUDIO_SAMPLES_ADPCM;
+
+    if (slot_map_is_full(audio_state->sources)) {
+        debug_print("Error: Maximum audio sources reached\n");
+        goto cleanup;
+    }
+
+    stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+    usize capacity_frames = audio_decoded_capacity(vorbis);
+    if (capacity_frames == 0) {
+        debug_print("Error: Could not read the OGG stream length\n");
+        goto cleanup;
+    }
+
+    debug_print("  Original: %d Hz, %d channels\n", info.sample_rate, info.channels);
+    debug_print("  Target: %d Hz, %d channels, up to %zu frames\n", AUDIO_SAMPLE_RATE, AUDIO_CHANNELS, capacity_frames);
+
+    if (adpcm) {
+        uint8* adpcm_blocks = arena_alloc(permanent_storage, audio_adpcm_size(capacity_frames, AUDIO_CHANNELS));
+        if (!adpcm_blocks) {
+            debug_print("Error: Permanent arena out of memory for ADPCM audio data\n");
+            goto cleanup;
         }
-        
-        source->static_data.current_position++;
+
+        usize frame_count = audio_decode_vorbis_adpcm(vorbis, transient_storage, adpcm_blocks, capacity_frames);
+        if (frame_count == 0) {
+            debug_print("Error: Failed to decode OGG data\n");
+            goto cleanup;
+        }
+
+        // The disk cache only holds PCM, ADPCM is cheap to encode again
+        AudioCachedSamples* cached = audio_sample_cache_put(permanent_storage, audio_state, cache_key, nullptr, frame_count);
+        if (cached) cached->adpcm_blocks = adpcm_blocks;
+        handle = audio_source_insert_adpcm(audio_state, adpcm_blocks, frame_count, request->loop);
+
+        debug_print("Successfully loaded static audio: %zu frames, %d channels, %d Hz, ADPCM, %zu KB (slot %u)\n",
+            frame_count, AUDIO_CHANNELS, AUDIO_SAMPLE_RATE,
+            audio_adpcm_size(frame_count, AUDIO_CHANNELS) / 1024, handle.index);
+        goto cleanup;
     }
+
+    int16* samples = arena_alloc(permanent_storage, capacity_frames * AUDIO_CHANNELS * sizeof(int16));
+    if (!samples) {
+        debug_print("Error: Permanent arena out of memory for audio data\n");
+        goto cleanup;
+    }
+
+    usize range_count = decode_ranges != AUDIO_DECODE_RANGES_AUTO
+        ? decode_ranges
+        : (usize)thread_hardware_concurrency();
+    range_count = MAX(MIN(range_count, capacity_frames / AUDIO_DECODE_MIN_RANGE_FRAMES), (usize)1);
+
+    usize frame_count = 0;
+    if (range_count > 1) {
+        debug_print("  Decoding in %zu parallel ranges\n", range_count);
+        frame_count = audio_decode_vorbis_ranges(
+            transient_storage, request, vorbis, samples, capacity_frames, range_count);
+    } else {
+        frame_count = audio_decode_vorbis_range(vorbis, transient_storage, samples, 0, capacity_frames);
+    }
+    if (frame_count == 0) {
+        debug_print("Error: Failed to decode OGG data\n");
+        goto cleanup;
+    }
+
+    audio_sample_cache_put(permanent_storage, audio_state, cache_key, samples, frame_count);
+    audio_sample_cache_store(audio_state, cache_key, samples, frame_count);
+    handle = audio_source_insert_static(audio_state, samples, frame_count, request->loop);
+
+    debug_print("Successfully loaded static audio: %zu frames, %d channels, %d Hz (slot %u)\n",
+        frame_count, AUDIO_CHANNELS, AUDIO_SAMPLE_RATE, handle.index);
+
+cleanup:
+    stb_vorbis_close(vorbis);
+    arena_temp_end(temp);
+    return handle;
 }
 
-static void process_streaming_audio_source(AudioSource* source, AudioState* audio_state, usize frames_needed) {
-    assert(source != nullptr);
-    usize frames_processed = 0;
-    
-    while (frames_processed < frames_needed && source->is_playing) {
-        if (source->stream_data.buffer_position >= source->stream_data.buffer_valid) {
-            if (!audio_source_stream_refill_buffer(source)) {
-                source->is_playing = false;
-                break;
-            }
+/**
+ * @brief Picks how static sources created from now on keep their samples. ADPCM takes about
+ * a quarter of the memory for a small mix-time cost, see audio_adpcm.h. It applies to
+ * create_audio_source_static and create_audio_source_static_memory, batch, cooked and lazy
+ * sources stay PCM16.
+ */
+void audio_set_static_format(AudioState* audio_state, AudioSampleFormat format) {
+    audio_state->static_format = format;
+}
+
+/**
+ * @brief Switches create_audio_source_static and create_audio_source_static_memory to lazy
+ * loading: sources only register the OGG bytes, decode on the decoder thread on their first
+ * play, and the least recently played idle ones are evicted to keep the decoded samples
+ * within `budget_bytes`. Hit, miss and eviction counters are in audio_state->lazy.
+ * Calling it again only changes the budget.
+ */
+bool audio_lazy_enable(Arena* permanent_storage, AudioState* audio_state, usize budget_bytes) {
+    assert(budget_bytes > 0 && "Lazy loading needs a budget");
+    if (audio_state->lazy.requests.data) {
+        audio_state->lazy.budget_bytes = budget_bytes;
+        return true;
+    }
+
+    // The decoder thread polls the request ring, so it is set up while the thread is stopped
+    bool restart = audio_state->decoder_thread.running;
+    if (restart) audio_decoder_stop(audio_state);
+
+    // A lazy source is queued at most once at a time, so the ring never fills up
+    bool ok = spsc_ring_init(&audio_state->lazy.requests, permanent_storage, sizeof(AudioLazySamples*), MAX_AUDIO_SOURCES);
+    if (ok) {
+        audio_state->lazy.budget_bytes = budget_bytes;
+        debug_print("Lazy static audio: %zu KB budget\n", budget_bytes / 1024);
+    }
+
+    if (restart) audio_decoder_start(audio_state);
+    return ok;
+}
+
+// Points a lazy entry at the OGG its sources decode from. Bytes that do not outlive the
+// call (`copy_data`) are copied into the permanent arena, once per entry.
+static bool audio_lazy_adopt_data(
+    Arena* permanent_storage,
+    AudioLazySamples* lazy,
+    const uint8* data,
+    usize data_size,
+    bool copy_data
+) {
+    if (copy_data) {
+        uint8* copy = arena_alloc(permanent_storage, data_size);
+        if (!copy) {
+            debug_print("Error: Permanent arena out of memory for lazy audio\n");
+            return false;
         }
-        
-        usize frames_available = source->stream_data.buffer_valid - source->stream_data.buffer_position;
-        usize frames_to_process = (frames_needed - frames_processed < frames_available) 
-                                ? frames_needed - frames_processed 
-                                : frames_available;
-        
-        for (usize frame = 0; frame < frames_to_process; frame++) {
-            usize stream_frame_idx = source->stream_data.buffer_position + frame;
-            usize output_frame_idx = frames_processed + frame;
-            
-            if (source->sample_rate == (int)AUDIO_SAMPLE_RATE && 
-                source->channels == (int)AUDIO_CHANNELS) {
-                for (usize ch = 0; ch < AUDIO_CHANNELS; ch++) {
-                    usize src_idx = stream_frame_idx * source->channels + ch;
-                    usize dst_idx = output_frame_idx * AUDIO_CHANNELS + ch;
-                    
-                    int mixed = (int)audio_state->audio[dst_idx] + (int)(source->stream_data.stream_buffer[src_idx] * source->volume);
-                    
-                    audio_state->audio[dst_idx] = (int16)CLAMP(mixed, -32768, 32767);
-                }
+        memcpy(copy, data, data_size);
+        data = copy;
+    }
+    lazy->data = data;
+    lazy->data_size = data_size;
+    lazy->owns_data = copy_data;
+    return true;
+}
+
+// Registers an OGG in memory without decoding it, see audio_lazy_enable
+static AudioSourceHandle create_audio_source_static_lazy(
+    Arena* permanent_storage,
+    AudioState* audio_state,
+    const uint8* data,
+    usize data_size,
+    bool loop,
+    bool copy_data
+) {
+    if (slot_map_is_full(audio_state->sources)) {
+        debug_print("Error: Maximum audio sources reached\n");
+        return (AudioSourceHandle){};
+    }
+
+    // Identical bytes share one mapping, and samples an eager load already decoded for good
+    // need no lazy state at all
+    uint64 cache_key = audio_sample_cache_key(data, data_size, AUDIO_SAMPLES_PCM16);
+    AudioCachedSamples* cached = audio_sample_cache_get(audio_state, cache_key);
+    if (cached && cached->samples) {
+        debug_print("Static OGG already decoded, sharing %zu frames\n", cached->frame_count);
+        return audio_source_insert_static(audio_state, cached->samples, cached->frame_count, loop);
+    }
+
+    AudioLazySamples* lazy = cached ? cached->lazy : nullptr;
+    if (lazy) {
+        // The bytes of the sources that registered it may be gone with them, unless it kept a copy
+        if (lazy->source_count == 0 && !lazy->owns_data &&
+            !audio_lazy_adopt_data(permanent_storage, lazy, data, data_size, copy_data)) {
+            return (AudioSourceHandle){};
+        }
+        debug_print("Lazy static OGG already registered, sharing its samples\n");
+    } else {
+        lazy = arena_alloc(permanent_storage, sizeof(AudioLazySamples));
+        if (!lazy) {
+            debug_print("Error: Permanent arena out of memory for lazy audio\n");
+            return (AudioSourceHandle){};
+        }
+        memset(lazy, 0, sizeof(AudioLazySamples));
+        if (!audio_lazy_adopt_data(permanent_storage, lazy, data, data_size, copy_data)) {
+            return (AudioSourceHandle){};
+        }
+
+        // Without a cache entry the source still works, it just shares nothing
+        cached = audio_sample_cache_put(permanent_storage, audio_state, cache_key, nullptr, 0);
+        if (cached) cached->lazy = lazy;
+        debug_print("Registered lazy static audio: %zu bytes of OGG\n", data_size);
+    }
+
+    AudioSourceHandle handle = audio_source_insert_static(audio_state, nullptr, 0, loop);
+    AudioSource* source = slot_map_get(audio_state->sources, handle);
+    source->static_data.lazy = lazy;
+    lazy->source_count++;
+
+    // Already resident through another source, playable right away
+    if (atomic_load(&lazy->state) == AUDIO_LAZY_RESIDENT) {
+        source->static_data.samples = lazy->samples;
+        source->static_data.frame_count = lazy->frame_count;
+        source->static_data.sample_count = lazy->frame_count * AUDIO_CHANNELS;
+    }
+    return handle;
+}
+
+/**
+ * @brief Loads an in-memory OGG as a static source. Identical OGGs share one decoded copy
+ * through the sample cache, see audio_sample_cache_enable_disk to keep it across launches.
+ * With lazy loading on (audio_lazy_enable), only registers `data`, which must then outlive
+ * the source.
+ *
+ * Long streams can be decoded in `decode_ranges` parallel ranges with bit-identical output:
+ * AUDIO_DECODE_RANGES_SERIAL decodes on the calling thread, AUDIO_DECODE_RANGES_AUTO uses
+ * one range per hardware thread. Ranges are at
+ * least AUDIO_DECODE_MIN_RANGE_FRAMES long, so short sounds always decode serially. ADPCM
+ * sources encode as they decode, on the calling thread.
+ */
+AudioSourceHandle create_audio_source_static_memory(
+    Arena* permanent_storage,
+    Arena* transient_storage,
+    AudioState* audio_state,
+    const uint8* data,
+    usize data_size,
+    bool loop,
+    uint32 decode_ranges
+) {
+    if (data_size > INT_MAX) {
+        debug_print("Error: ogg size bigger than the maximum allowed in stb_vorbis\n");
+        return (AudioSourceHandle){};
+    }
+
+    if (audio_state->lazy.budget_bytes > 0) {
+        return create_audio_source_static_lazy(permanent_storage, audio_state, data, data_size, loop, false);
+    }
+
+    AudioSampleFormat format = audio_state->static_format;
+    uint64 cache_key = audio_sample_cache_key(data, data_size, format);
+    AudioCachedSamples* cached = format == AUDIO_SAMPLES_PCM16
+        ? audio_sample_cache_find(permanent_storage, audio_state, cache_key)
+        : audio_sample_cache_get(audio_state, cache_key);
+    if (cached) {
+        debug_print("Static OGG already decoded, sharing %zu frames\n", cached->frame_count);
+        return cached->adpcm_blocks
+            ? audio_source_insert_adpcm(audio_state, cached->adpcm_blocks, cached->frame_count, loop)
+            : audio_source_insert_static(audio_state, cached->samples, cached->frame_count, loop);
+    }
+
+    AudioLoadRequest request = { .data = data, .data_size = data_size, .loop = loop };
+    debug_print("Loading static OGG from memory\n");
+    return create_audio_source_static_decoded(
+        permanent_storage, transient_storage, audio_state, &request, cache_key, decode_ranges);
+}
+
+AudioSourceHandle create_audio_source_static(
+    Arena* permanent_storage,
+    Arena* transient_storage,
+    AudioState* audio_state,
+    const char* filename,
+    bool loop
+) {
+    // The file is hashed for the sample cache anyway, so it is decoded from memory. Lazy
+    // sources copy the compressed bytes out of the transient arena, unless a source sharing
+    // the same asset already did.
+    ArenaTemp temp = arena_temp_begin(transient_storage);
+    usize data_size = 0;
+    uint8* data = audio_read_file(transient_storage, filename, &data_size);
+
+    AudioSourceHandle handle = {};
+    if (!data) {
+        debug_print("Error: Could not read OGG file '%s'\n", filename);
+    } else if (audio_state->lazy.budget_bytes > 0 && data_size <= INT_MAX) {
+        debug_print("Registering lazy static OGG: %s\n", filename);
+        handle = create_audio_source_static_lazy(permanent_storage, audio_state, data, data_size, loop, true);
+    } else {
+        debug_print("Loading static OGG: %s\n", filename);
+        handle = create_audio_source_static_memory(
+            permanent_storage, transient_storage, audio_state, data, data_size, loop,
+            AUDIO_DECODE_RANGES_SERIAL);
+    }
+
+    arena_temp_end(temp);
+    return handle;
+}
+
+// Called once per asset, in completion order: on the worker that decoded it, or on the calling
+// thread for assets shared through the sample cache. Must be thread-safe.
+typedef void AudioLoadCallback(AudioLoadRequest* request, bool loaded, void* user_data);
+
+typedef struct {
+    const uint8* data;            // The request's OGG, read from its file if it has one
+    usize data_size;
+    uint64 cache_key;
+    AudioCachedSamples* cached;   // Samples this asset shares, decoded or being decoded by another
+    stb_vorbis* vorbis;           // Opened by the probe when the asset decodes, closed by its job
+    usize capacity_frames;
+    int16* samples;               // Its region of the permanent arena
+    usize frame_count;            // Decoded frames, 0 on failure
+} AudioLoadSlot;
+
+typedef struct {
+    AudioState* audio_state;
+    AudioLoadRequest* requests;
+    AudioLoadSlot* slots;
+    AudioLoadCallback* callback;
+    void* user_data;
+} AudioLoadBatch;
+
+// Worker: decodes one asset into its pre-allocated region, with its own scratch
+static void audio_load_decode_job(void* data, usize index) {
+    AudioLoadBatch* batch = (AudioLoadBatch*)data;
+    AudioLoadRequest* request = &batch->requests[index];
+    AudioLoadSlot* slot = &batch->slots[index];
+
+    // Assets sharing cached samples are settled once every decode is done
+    if (!slot->samples && slot->cached) return;
+
+    if (slot->samples) {
+        ArenaTemp scratch = scratch_begin(nullptr, 0);
+        slot->frame_count = audio_decode_vorbis_range(slot->vorbis, scratch.arena, slot->samples, 0, slot->capacity_frames);
+        scratch_end(scratch);
+    }
+    stb_vorbis_close(slot->vorbis);
+    slot->vorbis = nullptr;
+
+    bool loaded = slot->frame_count > 0;
+    if (loaded) {
+        // Sources are not added or removed while the batch runs, so the pointer is stable
+        AudioSource* source = slot_map_get(batch->audio_state->sources, request->handle);
+        source->static_data.frame_count = slot->frame_count;
+        source->static_data.sample_count = slot->frame_count * AUDIO_CHANNELS;
+    }
+
+    if (batch->callback) {
+        batch->callback(request, loaded, batch->user_data);
+    }
+}
+
+/**
+ * @brief Loads many static sources at once, decoding them in parallel on the job workers.
+ *
+ * Each asset decodes into its own region of `permanent_storage`, sized up front on the
+ * calling thread. Assets already in the sample cache, or repeated within the batch, are
+ * decoded once and shared. Returns once every asset finished, with the number that loaded.
+ * `on_loaded` is optional, see AudioLoadCallback.
+ */
+usize create_audio_sources_static_batch(
+    Arena* permanent_storage,
+    Arena* transient_storage,
+    AudioState* audio_state,
+    AudioLoadRequest* requests,
+    usize request_count,
+    AudioLoadCallback* on_loaded,
+    void* user_data
+) {
+    ArenaTemp temp = arena_temp_begin(transient_storage);
+    usize loaded_count = 0;
+
+    AudioLoadSlot* slots = arena_alloc(transient_storage, request_count * sizeof(AudioLoadSlot));
+    if (!slots) {
+        debug_print("Error: Transient arena out of memory for audio batch\n");
+        arena_temp_end(temp);
+        return 0;
+    }
+    memset(slots, 0, request_count * sizeof(AudioLoadSlot));
+
+    AudioLoadBatch batch = {
+        .audio_state = audio_state,
+        .requests = requests,
+        .slots = slots,
+        .callback = on_loaded,
+        .user_data = user_data,
+    };
+
+    // Opening, the arena and the slot map are single-threaded: stb_vorbis rewrites a global
+    // CRC table on every open and reads it while seeking for the stream length
+    for (usize i = 0; i < request_count; i++) {
+        AudioLoadRequest* request = &requests[i];
+        AudioLoadSlot* slot = &slots[i];
+        request->handle = (AudioSourceHandle){};
+
+        slot->data = request->data;
+        slot->data_size = request->data_size;
+        if (!slot->data) {
+            slot->data = audio_read_file(transient_storage, request->filename, &slot->data_size);
+            if (!slot->data) {
+                debug_print("Error: Could not read OGG file '%s'\n", request->filename);
                 continue;
             }
-            if (source->channels == 1 && AUDIO_CHANNELS == 2) {
-                int16 mono_sample = (int16)(source->stream_data.stream_buffer[stream_frame_idx] * source->volume);
-                usize dst_idx = output_frame_idx * 2;
-                
-                int mixed_l = (int)audio_state->audio[dst_idx + 0] + mono_sample;
-                int mixed_r = (int)audio_state->audio[dst_idx + 1] + mono_sample;
-                
-                audio_state->audio[dst_idx + 0] = (int16)CLAMP(mixed_l, -32768, 32767);
-                audio_state->audio[dst_idx + 1] = (int16)CLAMP(mixed_r, -32768, 32767);
-            }
         }
-        
-        source->stream_data.buffer_position += frames_to_process;
-        frames_processed += frames_to_process;
+        if (slot->data_size > INT_MAX) continue;
+
+        slot->cache_key = audio_sample_cache_key(slot->data, slot->data_size, AUDIO_SAMPLES_PCM16);
+        slot->cached = audio_sample_cache_find(permanent_storage, audio_state, slot->cache_key);
+        if (slot->cached) {
+            request->handle = audio_source_insert_static(
+                audio_state, slot->cached->samples, slot->cached->frame_count, request->loop);
+            continue;
+        }
+
+        if (slot_map_is_full(audio_state->sources)) {
+            debug_print("Error: Maximum audio sources reached\n");
+            continue;
+        }
+
+        AudioLoadRequest memory_request = { .data = slot->data, .data_size = slot->data_size };
+        slot->vorbis = audio_load_request_open(&memory_request);
+        if (!slot->vorbis) continue;
+
+        slot->capacity_frames = audio_decoded_capacity(slot->vorbis);
+        if (slot->capacity_frames == 0) continue;
+
+        slot->samples = arena_alloc(permanent_storage, slot->capacity_frames * AUDIO_CHANNELS * sizeof(int16));
+        if (!slot->samples) {
+            debug_print("Error: Permanent arena out of memory for audio data\n");
+            continue;
+        }
+
+        // Registered before decoding, so repeats later in the batch share these samples.
+        // The frame count is filled in once the decode is done.
+        slot->cached = audio_sample_cache_put(permanent_storage, audio_state, slot->cache_key, slot->samples, 0);
+        request->handle = audio_source_insert_static(audio_state, slot->samples, 0, request->loop);
+    }
+
+    job_run(audio_load_decode_job, &batch, request_count);
+
+    // Decoded assets first, so every cache entry is final before its sharers are settled
+    for (usize i = 0; i < request_count; i++) {
+        AudioLoadSlot* slot = &slots[i];
+        if (!slot->samples) continue;
+
+        if (slot->cached) slot->cached->frame_count = slot->frame_count;
+        if (slot->frame_count > 0) {
+            audio_sample_cache_store(audio_state, slot->cache_key, slot->samples, slot->frame_count);
+        } else if (slot->cached) {
+            hash_map_remove(&audio_state->sample_cache, hash_key_id(slot->cache_key));
+        }
+    }
+
+    for (usize i = 0; i < request_count; i++) {
+        AudioLoadRequest* request = &requests[i];
+        AudioLoadSlot* slot = &slots[i];
+        if (slot_handle_is_null(request->handle)) continue;
+
+        // Sharers were skipped by the jobs, they are completed and reported here
+        bool sharing = !slot->samples;
+        usize frame_count = sharing ? slot->cached->frame_count : slot->frame_count;
+        bool loaded = frame_count > 0;
+
+        if (sharing && loaded) {
+            AudioSource* source = slot_map_get(audio_state->sources, request->handle);
+            source->static_data.frame_count = frame_count;
+            source->static_data.sample_count = frame_count * AUDIO_CHANNELS;
+        }
+        if (sharing && on_loaded) {
+            on_loaded(request, loaded, user_data);
+        }
+
+        if (!loaded) {
+            debug_print("Error: Failed to decode OGG data (batch entry %zu)\n", i);
+            slot_map_remove(audio_state->sources, request->handle);
+            request->handle = (AudioSourceHandle){};
+            continue;
+        }
+        loaded_count++;
     }
+
+    debug_print("Loaded %zu/%zu static audio sources\n", loaded_count, request_count);
+    arena_temp_end(temp);
+    return loaded_count;
 }
 
-AudioSource* create_audio_source_static(
-    Arena* permanent_storage,
+/**
+ * @brief Creates a static source straight from a cooked sound, e.g. one that was #embed-ed
+ * or mapped. Nothing is decoded or copied: the source plays from `data`, which must stay
+ * alive, unchanged and 2-byte aligned for as long as the source exists.
+ */
+AudioSourceHandle create_audio_source_static_cooked(
     AudioState* audio_state,
-    const char* filename,
+    const uint8* data,
+    usize data_size,
     bool loop
 ) {
-    int error = 0;
-    AudioSource* source = nullptr;
-    stb_vorbis* vorbis = stb_vorbis_open_filename(filename, &error, nullptr);
+    AudioCookedHeader header;
+    const int16* samples;
+    if (!audio_cooked_parse(data, data_size, &header, &samples)) {
+        return (AudioSourceHandle){};
+    }
 
-    // TODO: Set a global MAX_AUDIO_SIZE to avoid overflowing this temporary arena
-    Arena temp_arena = create_arena(MB(100));
+    AudioSourceHandle handle = audio_source_insert_static(audio_state, samples, (usize)header.frame_count, loop);
+    debug_print("Loaded cooked audio: %zu frames (slot %u)\n", (usize)header.frame_count, handle.index);
+    return handle;
+}
 
-    if (audio_state->audio_sources_size >= MAX_AUDIO_SOURCES) {
+// Shared by the streaming creators: takes ownership of `vorbis`, whatever it reads from.
+// `filename` is kept for reference and may be nullptr.
+static AudioSourceHandle create_audio_source_streaming_from_vorbis(
+    Arena* permanent_storage,
+    AudioState* audio_state,
+    stb_vorbis* vorbis,
+    const char* filename,
+    uint32 lookahead_ms,
+    ResampleQuality quality,
+    bool loop
+) {
+    if (slot_map_is_full(audio_state->sources)) {
         debug_print("Error: Maximum audio sources reached\n");
-        goto cleanup;
-    }
-    
-    if (!vorbis) {
-        debug_print("Error: Could not open OGG file '%s' (error: %d)\n", filename, error);
-        goto cleanup;
+        stb_vorbis_close(vorbis);
+        return (AudioSourceHandle){};
     }
     
     stb_vorbis_info info = stb_vorbis_get_info(vorbis);
-    usize total_frames = stb_vorbis_stream_length_in_samples(vorbis);
-    
-    debug_print("Loading static OGG: %s\n", filename);
-    debug_print("  Original: %d Hz, %d channels, %zu frames\n", info.sample_rate, info.channels, total_frames);
-    debug_print("  Target: %zu Hz, %zu channels\n", AUDIO_SAMPLE_RATE, AUDIO_CHANNELS);
-    
-    // Decode entire file into transient memory first
-    usize total_input_samples = total_frames * info.channels;
-    int16* raw_samples = arena_alloc(&temp_arena, total_input_samples * sizeof(int16));
-    if (!raw_samples) {
-        debug_print("Error: Transient arena out of memory for raw samples\n");
-        goto cleanup;
-    }
-    
-    int decoded_frames = stb_vorbis_get_samples_short_interleaved(
-        vorbis, info.channels, raw_samples, (int)total_input_samples);
     
-    if (decoded_frames <= 0) {
-        debug_print("Error: Failed to decode OGG file\n");
-        goto cleanup;
+    debug_print("Loading streaming OGG: %s (%d Hz, %d channels)\n",
+        filename ? filename : "from memory", info.sample_rate, info.channels);
+
+    AudioSource source = {
+        .type = AUDIO_SOURCE_STREAMING,
+        .channels = info.channels,
+        .sample_rate = info.sample_rate,
+        .is_playing = false,
+        .loop = loop,
+        .volume = 1.0f,
+    };
+    source.stream_data.filename = filename ? arena_alloc(permanent_storage, strlen(filename) + 1) : nullptr;
+    AudioStream* stream = arena_alloc_aligned(permanent_storage, sizeof(AudioStream), alignof(AudioStream));
+
+    if ((filename && !source.stream_data.filename) || !stream) {
+        debug_print("Error: Failed to allocate stream state for streaming ogg\n");
+        stb_vorbis_close(vorbis);
+        return (AudioSourceHandle){};
     }
-    
-    debug_print("  Decoded %d frames successfully\n", decoded_frames);
-    
-    // Step 1: Handle sample rate conversion
-    int16* resampled_audio = nullptr;
-    usize resampled_frames = 0;
-    
-    if (info.sample_rate != (usize)AUDIO_SAMPLE_RATE) {
-        resampled_audio = resample_audio(
-            &temp_arena,
-            raw_samples,
-            (usize)decoded_frames,
-            info.channels, info.sample_rate,
-            (int)AUDIO_SAMPLE_RATE, &resampled_frames
-        );
-        // Note: raw_samples will be reclaimed on arena reset
-        debug_print("  After resampling: %zu frames\n", resampled_frames);
-    } else {
-        resampled_audio = raw_samples;
-        resampled_frames = (usize)decoded_frames;
-        debug_print("  No resampling needed\n");
+    if (filename) {
+        strcpy(source.stream_data.filename, filename);
     }
-    
-    // Step 2: Handle channel conversion
-    int16* final_audio = nullptr;
-    usize final_frames = resampled_frames;
-    
-    if (info.channels != (int)AUDIO_CHANNELS) {
-        debug_print("  Converting channels: %d -> %zu\n", info.channels, AUDIO_CHANNELS);
-        
-        usize final_samples = final_frames * AUDIO_CHANNELS;
-        final_audio = arena_alloc(permanent_storage, final_samples * sizeof(int16));
-        if (!final_audio) {
-            debug_print("Error: Arena out of memory for final audio\n");
-            goto cleanup;
+
+    memset(stream, 0, sizeof(AudioStream));
+    stream->vorbis = vorbis;
+    stream->channels = info.channels;
+    stream->loop = loop;
+    stream->lookahead_frames = (usize)AUDIO_SAMPLE_RATE * lookahead_ms / 1000;
+    stream->resample = info.sample_rate != (int)AUDIO_SAMPLE_RATE;
+    atomic_store(&stream->paused, true);
+
+    if (stream->resample) {
+        debug_print("  Resampling on the decoder thread: %d Hz -> %d Hz (%s)\n", info.sample_rate,
+            (int)AUDIO_SAMPLE_RATE, quality == RESAMPLE_SINC ? "sinc" : "linear");
+
+        if (info.channels > RESAMPLER_MAX_CHANNELS) {
+            debug_print("Error: Cannot resample %d channels\n", info.channels);
+            stb_vorbis_close(vorbis);
+            return (AudioSourceHandle){};
         }
-        
-        convert_channels(
-            resampled_audio,
-            info.channels,
-            final_audio,
-            (int)AUDIO_CHANNELS,
-            final_frames
-        );
 
-        debug_print("  After channel conversion: %zu samples\n", final_samples);
-    } else {
-        final_audio = resampled_audio;
-        debug_print("  No channel conversion needed\n");
+        bool ok = resampler_init(&stream->resampler, permanent_storage, info.channels,
+                                 info.sample_rate, (int)AUDIO_SAMPLE_RATE, quality, AUDIO_DECODE_CHUNK_FRAMES);
+        if (!ok) {
+            stb_vorbis_close(vorbis);
+            return (AudioSourceHandle){};
+        }
     }
 
-    usize permanent_sample_count = final_frames * AUDIO_CHANNELS;
-    int16* permanent_samples = arena_alloc(permanent_storage, permanent_sample_count * sizeof(int16));
-    if (!permanent_samples) {
-        debug_print("Error: Permanent arena out of memory for audio data\n");
-        goto cleanup;
+    // Room for the look-ahead plus a converted decode chunk, so the decoder never waits on a full ring
+    usize ring_frames = stream->lookahead_frames + 2 * AUDIO_DECODE_CHUNK_FRAMES;
+    if (!spsc_ring_init(&stream->ring, permanent_storage, info.channels * sizeof(int16), ring_frames)) {
+        stb_vorbis_close(vorbis);
+        return (AudioSourceHandle){};
     }
-    memcpy(permanent_samples, final_audio, permanent_sample_count * sizeof(int16));
-    
-    // Find empty slot
+    source.stream_data.stream = stream;
+
+    // There is one stream slot per source slot, so a free one always exists here
     for (usize i = 0; i < MAX_AUDIO_SOURCES; i++) {
-        if (audio_state->audio_sources[i].type == AUDIO_SOURCE_NONE) {
-            source = &audio_state->audio_sources[i];
+        if (!atomic_load(&audio_state->streams[i])) {
+            atomic_store(&audio_state->streams[i], stream);
             break;
         }
     }
     
-    if (!source) {
-        debug_print("Error: No available audio source slots\n");
-        goto cleanup;
+    AudioSourceHandle handle = slot_map_insert(audio_state->sources, source);
+    debug_print("Successfully created streaming audio source: %d Hz, %d channels, %u ms look-ahead\n", 
+        source.sample_rate, source.channels, lookahead_ms);
+
+    return handle;
+}
+
+/**
+ * @brief Opens an OGG file for streaming. The decoder thread keeps `lookahead_ms` of audio
+ * decoded ahead of the playhead, see audio_decoder_start. Files at another sample rate are
+ * converted on the decoder thread with the given quality.
+ */
+AudioSourceHandle create_audio_source_streaming(
+    Arena* permanent_storage,
+    AudioState* audio_state,
+    const char* filename,
+    uint32 lookahead_ms,
+    ResampleQuality quality,
+    bool loop
+) {
+    int error = 0;
+    stb_vorbis* vorbis = stb_vorbis_open_filename(filename, &error, nullptr);
+
+    if (!vorbis) {
+        debug_print("Error: Could not open OGG file '%s' for streaming\n", filename);
+        return (AudioSourceHandle){};
     }
-    
-    // Initialize static audio source
-    memset(source, 0, sizeof(AudioSource));
-    source->type = AUDIO_SOURCE_STATIC;
-    source->channels = (int)AUDIO_CHANNELS;
-    source->sample_rate = (int)AUDIO_SAMPLE_RATE;
-    source->is_playing = false;
-    source->loop = loop;
-    source->volume = 1.0f;
-    
-    source->static_data.samples = permanent_samples;
-    source->static_data.sample_count = final_frames * AUDIO_CHANNELS;
-    source->static_data.frame_count = final_frames;
-    source->static_data.current_position = 0;
-    
-    audio_state->audio_sources_size++;
-    
-    debug_print("Successfully loaded static audio: %zu frames, %d channels, %d Hz\n", 
-        source->static_data.frame_count, source->channels, source->sample_rate);
 
-cleanup:
-    stb_vorbis_close(vorbis);
-    arena_cleanup(&temp_arena);
-    return source;
+    return create_audio_source_streaming_from_vorbis(
+        permanent_storage, audio_state, vorbis, filename, lookahead_ms, quality, loop);
 }
 
-AudioSource* create_audio_source_static_memory(
+/**
+ * @brief Streams an OGG from memory (e.g. #embed or a mapped pack file), same look-ahead,
+ * resampling and looping as create_audio_source_streaming. Only the stream's ring buffer is
+ * decoded PCM, `data` must stay alive and unchanged for as long as the source exists.
+ */
+AudioSourceHandle create_audio_source_streaming_memory(
     Arena* permanent_storage,
     AudioState* audio_state,
     const uint8* data,
     usize data_size,
+    uint32 lookahead_ms,
+    ResampleQuality quality,
     bool loop
 ) {
     int error = 0;
-    stb_vorbis* vorbis = stb_vorbis_open_memory(data, (int)data_size, &error, nullptr);
-    AudioSource* source = nullptr;
+    stb_vorbis* vorbis = data_size <= INT_MAX
+        ? stb_vorbis_open_memory(data, (int)data_size, &error, nullptr)
+        : nullptr;
 
-    // TODO: Set a global MAX_AUDIO_SIZE to avoid overflowing this temporary arena
-    Arena temp_arena = create_arena(MB(100));
-
-    if (data_size > INT_MAX) {
-        debug_print("Error: ogg size bigger than the maximum allowed in stb_vorbis\n");
-        goto cleanup;
+    if (!vorbis) {
+        debug_print("Error: Could not open OGG data in memory for streaming (error: %d)\n", error);
+        return (AudioSourceHandle){};
     }
 
-    if (audio_state->audio_sources_size >= MAX_AUDIO_SOURCES) {
-        debug_print("Error: Maximum audio sources reached\n");
-        goto cleanup;
+    return create_audio_source_streaming_from_vorbis(
+        permanent_storage, audio_state, vorbis, nullptr, lookahead_ms, quality, loop);
+}
+
+/**
+ * @brief Resolves a handle, nullptr once the source was destroyed.
+ * The pointer is only valid until the next audio_source_destroy.
+ */
+AudioSource* audio_source_get(AudioState* audio_state, AudioSourceHandle handle) {
+    return slot_map_get(audio_state->sources, handle);
+}
+
+static void audio_voice_remove_at(AudioState* audio_state, usize dense_index) {
+    AudioVoice* voice = &audio_state->voices.data[dense_index];
+    AudioSource* source = audio_source_get(audio_state, voice->source);
+    if (source) {
+        assert(source->voice_count > 0);
+        source->voice_count--;
+        if (source->static_data.lazy) source->static_data.lazy->voice_count--;
     }
+    slot_map_remove(audio_state->voices, slot_map_handle_at(audio_state->voices, dense_index));
+}
 
-    if (!vorbis) {
-        debug_print("Error: Could not open OGG data in memory (error: %d)\n", error);
-        goto cleanup;
+// Picks the voice a new trigger replaces: the lowest priority, then oldest voice. At the
+// source's instance limit only its own voices are candidates, otherwise only voices that
+// do not outrank the trigger.
+static bool audio_voice_find_victim(
+    AudioState* audio_state,
+    AudioSourceHandle source_handle,
+    uint8 priority,
+    bool at_source_limit,
+    usize* victim
+) {
+    bool found = false;
+
+    for (usize i = 0; i < slot_map_len(audio_state->voices); i++) {
+        AudioVoice* voice = &audio_state->voices.data[i];
+        if (at_source_limit ? !slot_handle_equals(voice->source, source_handle) : voice->priority > priority) {
+            continue;
+        }
+
+        AudioVoice* best = found ? &audio_state->voices.data[*victim] : nullptr;
+        if (!best || voice->priority < best->priority ||
+            (voice->priority == best->priority && voice->serial < best->serial)) {
+            *victim = i;
+            found = true;
+        }
     }
 
-    stb_vorbis_info info = stb_vorbis_get_info(vorbis);
-    usize total_frames = stb_vorbis_stream_length_in_samples(vorbis);
+    return found;
+}
 
-    debug_print("Loading static OGG from memory\n");
-    debug_print("  Original: %d Hz, %d channels, %zu frames\n", info.sample_rate, info.channels, total_frames);
-    debug_print("  Target: %zu Hz, %zu channels\n", AUDIO_SAMPLE_RATE, AUDIO_CHANNELS);
-    debug_print("  Transient arena before loading: %.1f/%.1f KB used\n", 
-               arena_get_used(&temp_arena) / 1024.0f, temp_arena.size / 1024.0f);
-
-    // Decode entire file
-    usize total_input_samples = total_frames * info.channels;
-    int16* raw_samples = arena_alloc(
-        &temp_arena,
-        total_input_samples * sizeof(int16)
-    );
-    if (!raw_samples) {
-        debug_print("Error: Out of memory allocating raw samples\n");
-        goto cleanup;
+// Main thread: points every source sharing `lazy` at its current samples
+static void audio_lazy_sync_sources(AudioState* audio_state, AudioLazySamples* lazy) {
+    for (usize i = 0; i < slot_map_len(audio_state->sources); i++) {
+        AudioSource* source = &audio_state->sources.data[i];
+        if (source->static_data.lazy != lazy) continue;
+
+        source->static_data.samples = lazy->samples;
+        source->static_data.frame_count = lazy->frame_count;
+        source->static_data.sample_count = lazy->frame_count * AUDIO_CHANNELS;
     }
+}
 
-    int decoded_frames = stb_vorbis_get_samples_short_interleaved(
-        vorbis,
-        info.channels,
-        raw_samples,
-        (int)total_input_samples
-    );
+// Main thread: makes the sources sharing `lazy` playable
+static void audio_lazy_publish(AudioState* audio_state, AudioLazySamples* lazy) {
+    atomic_store(&lazy->state, AUDIO_LAZY_RESIDENT);
+    audio_lazy_sync_sources(audio_state, lazy);
+}
 
-    if (decoded_frames <= 0) {
-        // Note: raw_samples will be reclaimed on arena reset
-        debug_print("Error: Failed to decode OGG data in memory\n");
-        goto cleanup;
+// Main thread: returns the samples to the OS, they decode again on the next play
+static void audio_lazy_unmap(AudioState* audio_state, AudioLazySamples* lazy) {
+    if (lazy->samples) {
+        os_release(lazy->samples, lazy->mapped_bytes);
+        audio_state->lazy.resident_bytes -= lazy->mapped_bytes;
     }
 
-    debug_print("  Decoded %d frames successfully\n", decoded_frames);
+    lazy->samples = nullptr;
+    lazy->mapped_bytes = 0;
+    lazy->frame_count = 0;
+    atomic_store(&lazy->state, AUDIO_LAZY_EVICTED);
+    audio_lazy_sync_sources(audio_state, lazy);
+}
 
-    // Step 1: Handle sample rate conversion
-    int16* resampled_audio = nullptr;
-    usize resampled_frames = 0;
+// Evicts the least recently played resident samples that no voice is playing. Returns false
+// if there are none.
+static bool audio_lazy_evict_one(AudioState* audio_state) {
+    AudioLazySamples* victim = nullptr;
 
-    if (info.sample_rate != (usize)AUDIO_SAMPLE_RATE) {
-        resampled_audio = resample_audio(
-            &temp_arena,
-            raw_samples,
-            (usize)decoded_frames,
-            info.channels, info.sample_rate,
-            (int)AUDIO_SAMPLE_RATE, &resampled_frames
-        );
-        if (!resampled_audio) {
-            debug_print("Error: Resampling failed\n");
-            goto cleanup;
+    for (usize i = 0; i < slot_map_len(audio_state->sources); i++) {
+        AudioLazySamples* lazy = audio_state->sources.data[i].static_data.lazy;
+        if (!lazy || lazy->voice_count > 0 || atomic_load(&lazy->state) != AUDIO_LAZY_RESIDENT) continue;
+
+        if (!victim || lazy->last_used < victim->last_used) {
+            victim = lazy;
         }
-        // Note: raw_samples will be reclaimed on arena reset
-        debug_print("  After resampling: %zu frames\n", resampled_frames);
-    } else {
-        resampled_audio = raw_samples;
-        resampled_frames = (usize)decoded_frames;
-        debug_print("  No resampling needed\n");
     }
 
-    // Step 2: Handle channel conversion
-    int16* final_audio = nullptr;
-    usize final_frames = resampled_frames;
+    if (!victim) return false;
+    audio_lazy_unmap(audio_state, victim);
+    audio_state->lazy.evictions++;
+    return true;
+}
 
-    if (info.channels != (int)AUDIO_CHANNELS) {
-        debug_print("  Converting channels: %d -> %zu\n", info.channels, AUDIO_CHANNELS);
+// Main thread: makes sure a lazy source's samples are resident or on their way before a
+// voice plays it. Returns false if they cannot be decoded or do not fit the budget.
+static bool audio_lazy_acquire(AudioState* audio_state, AudioSource* source) {
+    AudioLazySamples* lazy = source->static_data.lazy;
+    lazy->last_used = ++audio_state->lazy.clock;
 
-        usize final_samples = final_frames * AUDIO_CHANNELS;
-        final_audio = arena_alloc(
-            &temp_arena,
-            final_samples * sizeof(int16)
-        );
-        if (!final_audio) {
-            debug_print("Error: Transient arena out of memory for final audio\n");
-            goto cleanup;
-        }
+    uint32 state = atomic_load(&lazy->state);
+    if (state == AUDIO_LAZY_FAILED) return false;
+    if (state != AUDIO_LAZY_EVICTED) {
+        audio_state->lazy.hits++;
+        return true;
+    }
+    audio_state->lazy.misses++;
 
-        convert_channels(
-            resampled_audio,
-            info.channels,
-            final_audio,
-            (int)AUDIO_CHANNELS,
-            final_frames
-        );
+    // Opening stays on this thread with every other open, see audio_lazy_decode_step
+    AudioLoadRequest request = { .data = lazy->data, .data_size = lazy->data_size };
+    lazy->vorbis = audio_load_request_open(&request);
+    if (!lazy->vorbis) return false;
 
-        // Note: resampled_audio will be reclaimed on arena reset
-        debug_print("  After channel conversion: %zu samples\n", final_samples);
-    } else {
-        final_audio = resampled_audio;
-        debug_print("  No channel conversion needed\n");
-    }
+    lazy->capacity_frames = audio_decoded_capacity(lazy->vorbis);
+    usize bytes = arena_align_up(lazy->capacity_frames * AUDIO_CHANNELS * sizeof(int16), os_page_size());
 
-    if (!final_audio) {
-        debug_print("Error: final_audio is null - this should not happen\n");
-        goto cleanup;
-    }
+    // Idle sources make room, least recently played first
+    while (audio_state->lazy.resident_bytes + bytes > audio_state->lazy.budget_bytes &&
+           audio_lazy_evict_one(audio_state)) {}
 
-    for (usize i = 0; i < MAX_AUDIO_SOURCES; i++) {
-        debug_print("  Checking slot %zu: type=%d\n", i, audio_state->audio_sources[i].type);
-        if (audio_state->audio_sources[i].type == AUDIO_SOURCE_NONE) {
-            source = &audio_state->audio_sources[i];
-            debug_print("  Using slot %zu\n", i);
-            break;
+    void* samples = nullptr;
+    if (lazy->capacity_frames == 0) {
+        debug_print("Error: Could not read the OGG stream length\n");
+    } else if (audio_state->lazy.resident_bytes + bytes > audio_state->lazy.budget_bytes) {
+        debug_print("Error: Lazy audio needs %zu KB, playing sources hold %zu of the %zu KB budget\n",
+            bytes / 1024, audio_state->lazy.resident_bytes / 1024, audio_state->lazy.budget_bytes / 1024);
+    } else {
+        // Its own mapping, so an eviction gives the pages back instead of fragmenting an arena
+        samples = os_reserve(bytes);
+        if (samples && !os_commit(samples, bytes)) {
+            os_release(samples, bytes);
+            samples = nullptr;
         }
+        if (!samples) debug_print("Error: Could not map %zu KB for lazy audio\n", bytes / 1024);
     }
 
-    if (!source) {
-        debug_print("Error: No available audio source slots\n");
-        goto cleanup;
-    }
-
-    // Now copy final audio data to permanent storage
-    usize permanent_sample_count = final_frames * AUDIO_CHANNELS;
-    int16* permanent_samples = arena_alloc(
-        permanent_storage,
-        permanent_sample_count * sizeof(int16)
-    );
-    if (!permanent_samples) {
-        debug_print("Error: Permanent arena out of memory for audio data\n");
-        goto cleanup;
+    if (!samples) {
+        stb_vorbis_close(lazy->vorbis);
+        lazy->vorbis = nullptr;
+        return false;
     }
-    memcpy(permanent_samples, final_audio, permanent_sample_count * sizeof(int16));
 
-    // Initialize static audio source - CRITICAL: Zero the entire structure first
-    memset(source, 0, sizeof(AudioSource));
-    source->type = AUDIO_SOURCE_STATIC;
-    source->channels = (int)AUDIO_CHANNELS;
-    source->sample_rate = (int)AUDIO_SAMPLE_RATE;
-    source->is_playing = false;
-    source->loop = loop;
-    source->volume = 1.0f;
-
-    source->static_data.samples = permanent_samples;
-    source->static_data.sample_count = final_frames * AUDIO_CHANNELS;
-    source->static_data.frame_count = final_frames;
-    source->static_data.current_position = 0;
+    lazy->samples = samples;
+    lazy->mapped_bytes = bytes;
+    audio_state->lazy.resident_bytes += bytes;
+    atomic_store(&lazy->cancelled, false);
 
-    audio_state->audio_sources_size++;
+    if (!audio_state->decoder_thread.running) {
+        // Nothing decodes in the background, so the play waits for it
+        ArenaTemp scratch = scratch_begin(nullptr, 0);
+        lazy->frame_count = audio_decode_vorbis_range(lazy->vorbis, scratch.arena, lazy->samples, 0, lazy->capacity_frames);
+        scratch_end(scratch);
+        stb_vorbis_close(lazy->vorbis);
+        lazy->vorbis = nullptr;
 
-    debug_print("Successfully loaded static audio from memory: %zu frames, %d channels, %d Hz (slot %zu)\n",
-        source->static_data.frame_count, source->channels, source->sample_rate, 
-        (usize)(source - audio_state->audio_sources));
+        if (lazy->frame_count == 0) {
+            debug_print("Error: Failed to decode lazy audio\n");
+            audio_lazy_unmap(audio_state, lazy);
+            return false;
+        }
+        audio_lazy_publish(audio_state, lazy);
+        return true;
+    }
 
-cleanup:
-    stb_vorbis_close(vorbis);
-    arena_cleanup(&temp_arena);
-    return source;
+    atomic_store(&lazy->state, AUDIO_LAZY_DECODING);
+    void* span;
+    usize free_count = spsc_ring_reserve(&audio_state->lazy.requests, &span);
+    assert(free_count > 0 && "Lazy sources are queued at most once at a time");
+    *(AudioLazySamples**)span = lazy;
+    spsc_ring_commit(&audio_state->lazy.requests, 1);
+    audio_state->lazy.pending_count++;
+    return true;
 }
 
-AudioSource* create_audio_source_streaming(
-    Arena* permanent_storage,
-    AudioState* audio_state,
-    const char* filename,
-    int stream_buffer_frames,
-    bool loop
-) {
-    int error = 0;
-    stb_vorbis* vorbis = stb_vorbis_open_filename(filename, &error, nullptr);
-    AudioSource* source = nullptr;
-
-    if (!vorbis) {
-        debug_print("Error: Could not open OGG file '%s' for streaming\n", filename);
-        return nullptr;
+/**
+ * @brief Starts a new voice of a static source, overlapping any voices already playing it.
+ * When the source is at its voice limit or the voice pool is full, a voice is stolen.
+ * Returns the null handle if every candidate outranks the new voice. Voices of a lazy source
+ * that is still decoding wait at their start until the samples are ready.
+ */
+AudioVoiceHandle audio_voice_play(AudioState* audio_state, AudioSourceHandle source_handle) {
+    AudioSource* source = audio_source_get(audio_state, source_handle);
+    if (!source) return (AudioVoiceHandle){};
+    assert(source->type == AUDIO_SOURCE_STATIC && "Only static sources play through voices");
+    if (source->static_data.lazy && !audio_lazy_acquire(audio_state, source)) {
+        return (AudioVoiceHandle){};
     }
 
-    if (audio_state->audio_sources_size >= MAX_AUDIO_SOURCES) {
-        debug_print("Error: Maximum audio sources reached\n");
-        stb_vorbis_close(vorbis);
-        return nullptr;
-    }
-    
-    stb_vorbis_info info = stb_vorbis_get_info(vorbis);
-    
-    debug_print("Loading streaming OGG: %s (%d Hz, %d channels)\n", filename, info.sample_rate, info.channels);
-    
-    // Find empty slot
-    for (usize i = 0; i < MAX_AUDIO_SOURCES; i++) {
-        if (audio_state->audio_sources[i].type == AUDIO_SOURCE_NONE && !audio_state->audio_sources[i].stream_data.vorbis) {
-            source = &audio_state->audio_sources[i];
-            break;
+    bool at_source_limit = source->max_voices != 0 && source->voice_count >= source->max_voices;
+    if (at_source_limit || slot_map_is_full(audio_state->voices)) {
+        usize victim = 0;
+        if (!audio_voice_find_victim(audio_state, source_handle, source->priority, at_source_limit, &victim)) {
+            return (AudioVoiceHandle){};
         }
-    }
-    
-    if (!source) {
-        debug_print("Error: No available audio source slots\n");
-        stb_vorbis_close(vorbis);
-        return source;
+        audio_voice_remove_at(audio_state, victim);
     }
 
-    // Initialize streaming source
-    memset(source, 0, sizeof(AudioSource));
-    source->type = AUDIO_SOURCE_STREAMING;
-    source->channels = info.channels;
-    source->sample_rate = info.sample_rate;
-    source->is_playing = false;
-    source->loop = loop;
-    source->volume = 1.0f;
-    source->stream_data.vorbis = vorbis;
-    source->stream_data.filename = arena_alloc(permanent_storage, strlen(filename) + 1);
+    AudioVoice voice = {
+        .source = source_handle,
+        .position = 0,
+        .volume = 1.0f,
+        .loop = source->loop,
+        .priority = source->priority,
+        .serial = audio_state->voice_serial++,
+    };
+    source->voice_count++;
+    if (source->static_data.lazy) source->static_data.lazy->voice_count++;
+    return slot_map_insert(audio_state->voices, voice);
+}
 
-    if (!source->stream_data.filename) {
-        debug_print("Error: Failed to allocate filename for streaming ogg\n");
-        stb_vorbis_close(vorbis);
-        return nullptr;
+/**
+ * @brief Resolves a voice handle, nullptr once the voice finished or was stolen.
+ */
+AudioVoice* audio_voice_get(AudioState* audio_state, AudioVoiceHandle handle) {
+    return slot_map_get(audio_state->voices, handle);
+}
+
+void audio_voice_stop(AudioState* audio_state, AudioVoiceHandle handle) {
+    if (!slot_map_contains(audio_state->voices, handle)) return;
+    audio_voice_remove_at(audio_state, audio_state->voices.slots[handle.index].dense_index);
+}
+
+void audio_voice_set_volume(AudioState* audio_state, AudioVoiceHandle handle, real32 volume) {
+    AudioVoice* voice = audio_voice_get(audio_state, handle);
+    if (voice) {
+        voice->volume = CLAMP(volume, 0.0f, 1.0f);
     }
+}
 
-    strcpy(source->stream_data.filename, filename);
-    source->stream_data.buffer_frames = stream_buffer_frames;
-    source->stream_data.stream_buffer = arena_alloc(
-        permanent_storage,
-        stream_buffer_frames * info.channels * sizeof(int16)
-    );
-    if (!source->stream_data.stream_buffer) {
-        debug_print("Error: Failed to allocate stream_buffer for streaming ogg\n");
-        stb_vorbis_close(vorbis);
-        return nullptr;
+static void audio_source_stop_voices(AudioState* audio_state, AudioSourceHandle handle) {
+    for (usize i = 0; i < slot_map_len(audio_state->voices);) {
+        if (slot_handle_equals(audio_state->voices.data[i].source, handle)) {
+            audio_voice_remove_at(audio_state, i);
+        } else {
+            i++;
+        }
     }
+}
 
-    source->stream_data.buffer_position = 0;
-    source->stream_data.buffer_valid = 0;
-    source->stream_data.end_of_file = false;
+/**
+ * @brief Starts playback. Static sources get a new voice on every call (see audio_voice_play),
+ * streaming sources restart their single playhead.
+ */
+void audio_source_play(AudioState* audio_state, AudioSourceHandle handle) {
+    AudioSource* source = audio_source_get(audio_state, handle);
+    if (!source) return;
     
-    audio_state->audio_sources_size++;
-    debug_print("Successfully created streaming audio source: %d Hz, %d channels\n", 
-        source->sample_rate, source->channels);
-
-    return source;
+    if (source->type == AUDIO_SOURCE_STATIC) {
+        audio_voice_play(audio_state, handle);
+    } else if (source->type == AUDIO_SOURCE_STREAMING) {
+        source->is_playing = true;
+        audio_stream_restart(source->stream_data.stream);
+    }
 }
 
-void audio_source_play(AudioSource* source) {
+/**
+ * @brief Stops the source, for static sources that is every voice playing it.
+ */
+void audio_source_stop(AudioState* audio_state, AudioSourceHandle handle) {
+    AudioSource* source = audio_source_get(audio_state, handle);
     if (!source) return;
-    
-    source->is_playing = true;
-    
+
+    source->is_playing = false;
     if (source->type == AUDIO_SOURCE_STATIC) {
-        source->static_data.current_position = 0;
+        audio_source_stop_voices(audio_state, handle);
     } else if (source->type == AUDIO_SOURCE_STREAMING) {
-        audio_source_stream_begin(source);
-        source->stream_data.buffer_position = 0;
-        source->stream_data.buffer_valid = 0;
-        source->stream_data.end_of_file = false;
+        audio_stream_pause(source->stream_data.stream);
+    }
+}
+
+void audio_source_set_voice_limit(AudioState* audio_state, AudioSourceHandle handle, uint32 max_voices) {
+    AudioSource* source = audio_source_get(audio_state, handle);
+    if (source) {
+        source->max_voices = max_voices;
     }
 }
 
-void audio_source_stop(AudioSource* source) {
+void audio_source_set_priority(AudioState* audio_state, AudioSourceHandle handle, uint8 priority) {
+    AudioSource* source = audio_source_get(audio_state, handle);
     if (source) {
-        source->is_playing = false;
+        source->priority = priority;
     }
 }
 
-void audio_source_set_volume(AudioSource* source, float volume) {
+void audio_source_set_volume(AudioState* audio_state, AudioSourceHandle handle, float volume) {
+    AudioSource* source = audio_source_get(audio_state, handle);
     if (source) {
         source->volume = CLAMP(volume, 0.0f, 1.0f);
     }
 }
 
-void audio_source_cleanup(AudioSource* source) {
-    if (!source) return;
-    
+static void audio_source_release(AudioState* audio_state, AudioSource* source) {
     source->is_playing = false;
-    
-    if (source->type == AUDIO_SOURCE_STATIC) {
-        // Note: Arena-allocated memory doesn't need explicit freeing
+
+    AudioLazySamples* lazy = source->static_data.lazy;
+    if (source->type == AUDIO_SOURCE_STATIC && lazy) {
+        source->static_data.lazy = nullptr;
         source->static_data.samples = nullptr;
-    } else if (source->type == AUDIO_SOURCE_STREAMING) {
-        if (source->stream_data.vorbis) {
-            audio_source_stream_end(source);
+        assert(lazy->source_count > 0);
+
+        // The samples stay while another source shares them. The last one lets them go and
+        // leaves the cache entry to be registered again.
+        if (--lazy->source_count == 0) {
+            // The decoder hands a queued or running decode back within a chunk of reaching it
+            atomic_store(&lazy->cancelled, true);
+            while (atomic_load(&lazy->state) == AUDIO_LAZY_DECODING) {
+                thread_yield();
+            }
+
+            uint32 state = atomic_load(&lazy->state);
+            if (state == AUDIO_LAZY_DECODED || state == AUDIO_LAZY_FAILED) {
+                audio_state->lazy.pending_count--;
+            }
+            audio_lazy_unmap(audio_state, lazy);
+            lazy->voice_count = 0;
         }
-        // Note: Arena-allocated memory doesn't need explicit freeing
-        source->stream_data.filename = nullptr;
-        source->stream_data.stream_buffer = nullptr;
     }
     
-    memset(source, 0, sizeof(AudioSource));
+    AudioStream* stream = source->stream_data.stream;
+    if (source->type == AUDIO_SOURCE_STREAMING && stream) {
+        audio_stream_pause(stream);
+        for (usize i = 0; i < MAX_AUDIO_SOURCES; i++) {
+            if (atomic_load(&audio_state->streams[i]) == stream) {
+                atomic_store(&audio_state->streams[i], nullptr);
+            }
+        }
+        stb_vorbis_close(stream->vorbis);
+        stream->vorbis = nullptr;
+    }
+    // Note: Arena-allocated memory doesn't need explicit freeing
+}
+
+/**
+ * @brief Releases the source and frees its slot, `handle` and any copies of it go stale.
+ */
+void audio_source_destroy(AudioState* audio_state, AudioSourceHandle handle) {
+    AudioSource* source = audio_source_get(audio_state, handle);
+    if (!source) return;
+
+    audio_source_stop_voices(audio_state, handle);
+    audio_source_release(audio_state, source);
+    slot_map_remove(audio_state->sources, handle);
 }
 
+// Main thread: publishes the lazy decodes the decoder thread handed back
+static void audio_lazy_update(AudioState* audio_state) {
+    if (audio_state->lazy.pending_count == 0) return;
+
+    for (usize i = 0; i < slot_map_len(audio_state->sources); i++) {
+        AudioSource* source = &audio_state->sources.data[i];
+        AudioLazySamples* lazy = source->static_data.lazy;
+        if (!lazy) continue;
+
+        // Sources sharing the samples are all settled by the first one found
+        uint32 state = atomic_load_explicit(&lazy->state, memory_order_acquire);
+        if (state == AUDIO_LAZY_DECODED) {
+            audio_lazy_publish(audio_state, lazy);
+            audio_state->lazy.pending_count--;
+        } else if (state == AUDIO_LAZY_FAILED) {
+            debug_print("Error: Failed to decode lazy audio (slot %u)\n", slot_map_handle_at(audio_state->sources, i).index);
+            for (usize j = 0; j < slot_map_len(audio_state->sources); j++) {
+                if (audio_state->sources.data[j].static_data.lazy == lazy) {
+                    audio_source_stop_voices(audio_state, slot_map_handle_at(audio_state->sources, j));
+                }
+            }
+            audio_lazy_unmap(audio_state, lazy);
+            audio_state->lazy.pending_count--;
+        }
+    }
+}
 
 void audio_state_update(AudioState* audio_state) {
-    memset(audio_state->audio, 0, AUDIO_CAPACITY * sizeof(int16));
+    audio_lazy_update(audio_state);
+    memset(audio_state->bus, 0, AUDIO_CAPACITY * sizeof(int32));
     
     usize frames_needed = AUDIO_CAPACITY / AUDIO_CHANNELS;
+    audio_state->real_voice_count = 0;
+    audio_state->virtual_voice_count = 0;
     
-    for (usize source_idx = 0; source_idx < MAX_AUDIO_SOURCES; source_idx++) {
-        AudioSource* source = &audio_state->audio_sources[source_idx];
-        if (!source->is_playing) continue;
-        
-        if (source->type == AUDIO_SOURCE_STATIC) {
-            process_static_audio_source(source, audio_state, frames_needed);
-        } else if (source->type == AUDIO_SOURCE_STREAMING) {
-            process_streaming_audio_source(source, audio_state, frames_needed);
+    // Finished voices are swap-removed, so the index only advances past live ones
+    for (usize voice_idx = 0; voice_idx < slot_map_len(audio_state->voices);) {
+        AudioVoice* voice = &audio_state->voices.data[voice_idx];
+        AudioSource* source = audio_source_get(audio_state, voice->source);
+
+        bool playing = false;
+        if (source && source->static_data.lazy && !source->static_data.samples) {
+            // Lazy source still decoding, the voice waits at its start
+            playing = true;
+        } else if (source) {
+            bool audible = audio_state->volume * source->volume * voice->volume >= AUDIO_AUDIBLE_THRESHOLD;
+            if (audible) {
+                playing = process_audio_voice(voice, source, audio_state, frames_needed);
+                audio_state->real_voice_count++;
+            } else {
+                playing = advance_virtual_audio_voice(voice, source, frames_needed);
+                audio_state->virtual_voice_count++;
+            }
+        }
+
+        if (playing) {
+            voice_idx++;
+        } else {
+            audio_voice_remove_at(audio_state, voice_idx);
         }
     }
+
+    // Only live sources are packed in the dense array, no empty slots to skip
+    for (usize source_idx = 0; source_idx < slot_map_len(audio_state->sources); source_idx++) {
+        AudioSource* source = &audio_state->sources.data[source_idx];
+        if (source->type == AUDIO_SOURCE_STREAMING && source->is_playing) {
+            bool audible = audio_state->volume * source->volume >= AUDIO_AUDIBLE_THRESHOLD;
+            process_streaming_audio_source(source, audio_state, frames_needed, audible);
+            if (audible) {
+                audio_state->real_voice_count++;
+            } else {
+                audio_state->virtual_voice_count++;
+            }
+        }
+    }
+
+    // Master volume and clipping happen once, after every source is summed
+    mix_bus_to_s16(audio_state->audio, audio_state->bus, AUDIO_CAPACITY, audio_state->volume);
 }
 
 void audio_state_cleanup(AudioState* audio_state) {
     debug_print("Cleaning up audio_state resources...\n");
     
-    for (usize i = 0; i < MAX_AUDIO_SOURCES; i++) {
-        audio_source_cleanup(&audio_state->audio_sources[i]);
+    slot_map_clear(audio_state->voices);
+
+    for (usize i = 0; i < slot_map_len(audio_state->sources); i++) {
+        audio_source_release(audio_state, &audio_state->sources.data[i]);
     }
     
-    audio_state->audio_sources_size = 0;
+    slot_map_clear(audio_state->sources);
 }
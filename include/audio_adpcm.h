@@ -0,0 +1,166 @@
+/**
+ * @file audio_adpcm.h
+ * @brief Block IMA-ADPCM, 4 bits per sample, for static sources kept compressed in memory.
+ *
+ * Every block carries its own decoder state, so any block decodes on its own and voices can
+ * start anywhere. A block is a header per channel (predictor, step index) followed by
+ * AUDIO_ADPCM_BLOCK_FRAMES interleaved samples, two per byte, low nibble first.
+ * The encoder tracks the decoder exactly, decoding always reproduces the same samples.
+ */
+#pragma once
+#include "def.h"
+
+// Frames per block: 256 stereo frames take 264 bytes instead of 1024
+constexpr usize AUDIO_ADPCM_BLOCK_FRAMES = 256;
+constexpr usize AUDIO_ADPCM_HEADER_BYTES = 4;      // Per channel: int16 predictor, step index, pad
+
+static const int16 audio_adpcm_steps[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+static const int8 audio_adpcm_index_steps[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+// Decoder state of one channel
+typedef struct {
+    int32 predictor;
+    int32 index;
+} AudioAdpcmChannel;
+
+static inline usize audio_adpcm_block_bytes(int channels) {
+    return (usize)channels * (AUDIO_ADPCM_HEADER_BYTES + AUDIO_ADPCM_BLOCK_FRAMES / 2);
+}
+
+static inline usize audio_adpcm_size(usize frame_count, int channels) {
+    usize blocks = (frame_count + AUDIO_ADPCM_BLOCK_FRAMES - 1) / AUDIO_ADPCM_BLOCK_FRAMES;
+    return blocks * audio_adpcm_block_bytes(channels);
+}
+
+// Applies one nibble to the channel state and returns the decoded sample
+static inline int16 audio_adpcm_step(AudioAdpcmChannel* channel, uint8 nibble) {
+    int32 step = audio_adpcm_steps[channel->index];
+    int32 delta = step >> 3;
+    if (nibble & 4) delta += step;
+    if (nibble & 2) delta += step >> 1;
+    if (nibble & 1) delta += step >> 2;
+
+    channel->predictor += (nibble & 8) ? -delta : delta;
+    channel->predictor = CLAMP(channel->predictor, -32768, 32767);
+    channel->index = CLAMP(channel->index + audio_adpcm_index_steps[nibble], 0, 88);
+    return (int16)channel->predictor;
+}
+
+// The reference IMA quantizer, its reconstruction is what audio_adpcm_step decodes
+static inline uint8 audio_adpcm_quantize(const AudioAdpcmChannel* channel, int16 sample) {
+    int32 step = audio_adpcm_steps[channel->index];
+    int32 diff = (int32)sample - channel->predictor;
+    uint8 nibble = 0;
+
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    if (diff >= step) {
+        nibble |= 4;
+        diff -= step;
+    }
+    if (diff >= step >> 1) {
+        nibble |= 2;
+        diff -= step >> 1;
+    }
+    if (diff >= step >> 2) {
+        nibble |= 1;
+    }
+    return nibble;
+}
+
+// Encoder state carried from one block to the next, zero-initialize before the first block
+typedef struct {
+    AudioAdpcmChannel channels[8];
+} AudioAdpcmEncoder;
+
+/**
+ * @brief Encodes the next `frame_count` interleaved frames of a stream into
+ * audio_adpcm_size bytes of blocks. A stream can be encoded a piece at a time, with the same
+ * blocks as in one go, as long as every piece but the last is a whole number of blocks.
+ * The last block is padded with silence.
+ */
+void audio_adpcm_encode_blocks(AudioAdpcmEncoder* encoder, uint8* blocks, const int16* samples, usize frame_count, int channels) {
+    AudioAdpcmChannel* state = encoder->channels;
+    assert(channels >= 1 && channels <= 8 && "Unsupported channel count");
+
+    for (usize first = 0; first < frame_count; first += AUDIO_ADPCM_BLOCK_FRAMES) {
+        uint8* header = blocks;
+        uint8* data = blocks + (usize)channels * AUDIO_ADPCM_HEADER_BYTES;
+        blocks += audio_adpcm_block_bytes(channels);
+
+        for (int c = 0; c < channels; c++) {
+            int16 predictor = (int16)state[c].predictor;
+            memcpy(header + c * AUDIO_ADPCM_HEADER_BYTES, &predictor, sizeof(predictor));
+            header[c * AUDIO_ADPCM_HEADER_BYTES + 2] = (uint8)state[c].index;
+            header[c * AUDIO_ADPCM_HEADER_BYTES + 3] = 0;
+        }
+
+        usize block_samples = AUDIO_ADPCM_BLOCK_FRAMES * (usize)channels;
+        usize available = MIN(frame_count - first, AUDIO_ADPCM_BLOCK_FRAMES) * (usize)channels;
+        const int16* src = samples + first * (usize)channels;
+
+        for (usize i = 0; i < block_samples; i += 2) {
+            uint8 byte = 0;
+            for (usize k = 0; k < 2; k++) {
+                AudioAdpcmChannel* channel = &state[(i + k) % (usize)channels];
+                int16 sample = i + k < available ? src[i + k] : 0;
+                uint8 nibble = audio_adpcm_quantize(channel, sample);
+                audio_adpcm_step(channel, nibble);
+                byte |= (uint8)(nibble << (4 * k));
+            }
+            data[i / 2] = byte;
+        }
+    }
+}
+
+// Encodes a whole stream, see audio_adpcm_encode_blocks
+void audio_adpcm_encode(uint8* blocks, const int16* samples, usize frame_count, int channels) {
+    AudioAdpcmEncoder encoder = {};
+    audio_adpcm_encode_blocks(&encoder, blocks, samples, frame_count, channels);
+}
+
+/**
+ * @brief Decodes the first `frame_count` frames of one block into interleaved samples.
+ * Decoding stops there, so a voice near the start of a block only pays for what it reads.
+ */
+static void audio_adpcm_decode_block(int16* out, const uint8* block, usize frame_count, int channels) {
+    assert(frame_count <= AUDIO_ADPCM_BLOCK_FRAMES && channels >= 1 && channels <= 8);
+    AudioAdpcmChannel state[8];
+
+    for (int c = 0; c < channels; c++) {
+        int16 predictor;
+        memcpy(&predictor, block + c * AUDIO_ADPCM_HEADER_BYTES, sizeof(predictor));
+        state[c] = (AudioAdpcmChannel){
+            .predictor = predictor,
+            .index = MIN(block[c * AUDIO_ADPCM_HEADER_BYTES + 2], 88),
+        };
+    }
+    const uint8* data = block + (usize)channels * AUDIO_ADPCM_HEADER_BYTES;
+
+    // Stereo is the common case, the channel never has to be looked up
+    if (channels == 2) {
+        for (usize i = 0; i < frame_count; i++) {
+            out[i * 2 + 0] = audio_adpcm_step(&state[0], data[i] & 0x0F);
+            out[i * 2 + 1] = audio_adpcm_step(&state[1], data[i] >> 4);
+        }
+        return;
+    }
+
+    usize sample_count = frame_count * (usize)channels;
+    for (usize i = 0; i < sample_count; i++) {
+        uint8 byte = data[i / 2];
+        out[i] = audio_adpcm_step(&state[i % (usize)channels], (i & 1) ? byte >> 4 : byte & 0x0F);
+    }
+}
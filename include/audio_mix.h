@@ -0,0 +1,171 @@
+/**
+ * @file audio_mix.h
+ * @brief Block mixing kernels: per-source fixed-point gain into an int32 bus, and the final
+ * master volume + clip pass down to int16.
+ *
+ * Every kernel has a scalar reference version, the SSE2/AVX2 paths produce bit-identical
+ * output. AVX2 is picked at compile time when the target enables it (e.g. -mavx2),
+ * x86-64 always has SSE2, other targets use the scalar path.
+ */
+#pragma once
+#include "def.h"
+
+#if defined(__AVX2__)
+#define AUDIO_MIX_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define AUDIO_MIX_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Q15 gain, AUDIO_GAIN_UNITY is exactly 1.0 and skips the multiply
+constexpr int32 AUDIO_GAIN_UNITY = 32768;
+
+static inline int32 audio_gain_q15(real32 volume) {
+    return (int32)(CLAMP(volume, 0.0f, 1.0f) * (real32)AUDIO_GAIN_UNITY + 0.5f);
+}
+
+static inline int32 audio_apply_gain(int16 sample, int32 gain) {
+    return ((int32)sample * gain) >> 15;
+}
+
+/**
+ * @brief Scalar reference: bus[i] += (src[i] * gain) >> 15. The bus is never clamped here,
+ * so the mix does not depend on source order.
+ */
+static void mix_s16_scalar(int32* bus, const int16* src, usize samples, int32 gain) {
+    for (usize i = 0; i < samples; i++) {
+        bus[i] += audio_apply_gain(src[i], gain);
+    }
+}
+
+/**
+ * @brief Scalar reference for mono sources: each gained sample is added to both channels.
+ */
+static void mix_s16_mono_to_stereo_scalar(int32* bus, const int16* src, usize frames, int32 gain) {
+    for (usize i = 0; i < frames; i++) {
+        int32 sample = audio_apply_gain(src[i], gain);
+        bus[i * 2 + 0] += sample;
+        bus[i * 2 + 1] += sample;
+    }
+}
+
+/**
+ * @brief Scalar reference for the output stage: scales by `master`, rounds to nearest and
+ * saturates to int16.
+ */
+static void mix_bus_to_s16_scalar(int16* out, const int32* bus, usize samples, real32 master) {
+    for (usize i = 0; i < samples; i++) {
+        real32 value = CLAMP((real32)bus[i] * master, -32768.0f, 32767.0f);
+        out[i] = (int16)lrintf(value);
+    }
+}
+
+#if AUDIO_MIX_SSE2
+// Widens 8 samples to (src * gain) >> 15 as two vectors of 4 int32
+static inline void audio_gain_sse2(__m128i src, __m128i gain, bool unity, __m128i* lo, __m128i* hi) {
+    if (unity) {
+        *lo = _mm_srai_epi32(_mm_unpacklo_epi16(src, src), 16);
+        *hi = _mm_srai_epi32(_mm_unpackhi_epi16(src, src), 16);
+        return;
+    }
+    // gain < 32768 here, so it fits the signed 16-bit multipliers
+    __m128i product_lo = _mm_mullo_epi16(src, gain);
+    __m128i product_hi = _mm_mulhi_epi16(src, gain);
+    *lo = _mm_srai_epi32(_mm_unpacklo_epi16(product_lo, product_hi), 15);
+    *hi = _mm_srai_epi32(_mm_unpackhi_epi16(product_lo, product_hi), 15);
+}
+
+static inline void audio_bus_add_sse2(int32* bus, __m128i value) {
+    _mm_storeu_si128((__m128i*)bus, _mm_add_epi32(_mm_loadu_si128((const __m128i*)bus), value));
+}
+#endif
+
+/**
+ * @brief Adds `samples` gained samples of `src` into the bus.
+ */
+static void mix_s16(int32* bus, const int16* src, usize samples, int32 gain) {
+    usize i = 0;
+    bool unity = gain >= AUDIO_GAIN_UNITY;
+
+#if AUDIO_MIX_AVX2
+    __m256i gain_256 = _mm256_set1_epi32(gain);
+    for (; i + 8 <= samples; i += 8) {
+        __m256i s = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+        if (!unity) s = _mm256_srai_epi32(_mm256_mullo_epi32(s, gain_256), 15);
+        __m256i b = _mm256_loadu_si256((const __m256i*)(bus + i));
+        _mm256_storeu_si256((__m256i*)(bus + i), _mm256_add_epi32(b, s));
+    }
+#elif AUDIO_MIX_SSE2
+    __m128i gain_128 = _mm_set1_epi16((int16)(unity ? 0 : gain));
+    for (; i + 8 <= samples; i += 8) {
+        __m128i lo, hi;
+        audio_gain_sse2(_mm_loadu_si128((const __m128i*)(src + i)), gain_128, unity, &lo, &hi);
+        audio_bus_add_sse2(bus + i, lo);
+        audio_bus_add_sse2(bus + i + 4, hi);
+    }
+#endif
+
+    mix_s16_scalar(bus + i, src + i, samples - i, gain);
+}
+
+/**
+ * @brief Adds `frames` gained mono samples of `src` into both channels of the stereo bus.
+ */
+static void mix_s16_mono_to_stereo(int32* bus, const int16* src, usize frames, int32 gain) {
+    usize i = 0;
+    bool unity = gain >= AUDIO_GAIN_UNITY;
+
+#if AUDIO_MIX_SSE2
+    __m128i gain_128 = _mm_set1_epi16((int16)(unity ? 0 : gain));
+    for (; i + 8 <= frames; i += 8) {
+        __m128i lo, hi;
+        audio_gain_sse2(_mm_loadu_si128((const __m128i*)(src + i)), gain_128, unity, &lo, &hi);
+
+        int32* dst = bus + i * 2;
+        audio_bus_add_sse2(dst + 0, _mm_unpacklo_epi32(lo, lo));
+        audio_bus_add_sse2(dst + 4, _mm_unpackhi_epi32(lo, lo));
+        audio_bus_add_sse2(dst + 8, _mm_unpacklo_epi32(hi, hi));
+        audio_bus_add_sse2(dst + 12, _mm_unpackhi_epi32(hi, hi));
+    }
+#endif
+
+    mix_s16_mono_to_stereo_scalar(bus + i * 2, src + i, frames - i, gain);
+}
+
+/**
+ * @brief The single clip stage: applies master volume to the bus and writes int16 output.
+ */
+static void mix_bus_to_s16(int16* out, const int32* bus, usize samples, real32 master) {
+    usize i = 0;
+
+#if AUDIO_MIX_AVX2
+    __m256 master_256 = _mm256_set1_ps(master);
+    __m256 min_256 = _mm256_set1_ps(-32768.0f);
+    __m256 max_256 = _mm256_set1_ps(32767.0f);
+    for (; i + 8 <= samples; i += 8) {
+        __m256 value = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(bus + i)));
+        value = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(value, master_256), min_256), max_256);
+        __m256i rounded = _mm256_cvtps_epi32(value);
+        __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(rounded), _mm256_extracti128_si256(rounded, 1));
+        _mm_storeu_si128((__m128i*)(out + i), packed);
+    }
+#elif AUDIO_MIX_SSE2
+    __m128 master_128 = _mm_set1_ps(master);
+    __m128 min_128 = _mm_set1_ps(-32768.0f);
+    __m128 max_128 = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= samples; i += 8) {
+        __m128 lo = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(bus + i)));
+        __m128 hi = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(bus + i + 4)));
+        lo = _mm_min_ps(_mm_max_ps(_mm_mul_ps(lo, master_128), min_128), max_128);
+        hi = _mm_min_ps(_mm_max_ps(_mm_mul_ps(hi, master_128), min_128), max_128);
+        // cvtps rounds to nearest even like lrintf, packs saturates like the scalar clamp
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+        _mm_storeu_si128((__m128i*)(out + i), packed);
+    }
+#endif
+
+    mix_bus_to_s16_scalar(out + i, bus + i, samples - i, master);
+}
@@ -9,7 +9,8 @@ constexpr int AUDIO_CHANNELS = 2;
 constexpr int AUDIO_CAPACITY = (AUDIO_SAMPLE_RATE / FPS) * AUDIO_CHANNELS;
 
 constexpr int MAX_AUDIO_SOURCES = 16;
-constexpr int STREAM_BUFFER_FRAMES = 4096;
+constexpr int MAX_AUDIO_VOICES = 256;
+constexpr int STREAM_LOOKAHEAD_MS = 250;
 
 constexpr int WORLD_WIDTH = 320;
 constexpr int WORLD_HEIGHT = 180;
@@ -1,5 +1,12 @@
 #pragma once
 
+// Strict -std=c23 hides the POSIX and BSD parts of libc (mmap flags, madvise, clock_gettime).
+// _DEFAULT_SOURCE brings them back without narrowing anything, unlike _POSIX_C_SOURCE which
+// hides MAP_ANON on macOS. It only works before the first system header.
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
 #include <assert.h>
 #include <math.h>
 #include <stdint.h>
@@ -36,6 +43,8 @@
 #define GB(number) (MB(number) * 1024ull)
 #define TB(number) (GB(number) * 1024ull)
 #define ARRAY_LEN(arr) (sizeof(arr) / sizeof((arr)[0]))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define CLAMP(val, lo, hi) ((val) < (lo) ? (lo) : ((val) > (hi) ? (hi) : (val)))
 #define RGBA(r, g, b, a) (r / 255.0f), (g / 255.0f), (b / 255.0f), (a / 255.0f)
 
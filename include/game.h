@@ -38,13 +38,24 @@ typedef struct {
     bool is_visible;
 } Tile;
 
+// Everything that lives for one room/level, allocated from GameState.level_storage
+typedef struct {
+    uint32 index;
+    Tile world_grid[WORLD_GRID.x][WORLD_GRID.y];
+} Level;
+
 typedef struct {
     bool should_quit;
     bool fps_cap;
     IVec2 player_position;
 
+    // Level tier: game_level_update resets level_storage between game_level_exit and
+    // game_level_enter whenever requested_level differs from the loaded one
+    Arena* level_storage;
+    Level* level;
+    uint32 requested_level;
+
     ARRAY(IVec2, 21) tile_coords;
-    Tile world_grid[WORLD_GRID.x][WORLD_GRID.y];
     KeyMapping key_mappings[GAME_INPUT_COUNT];
 } GameState;
 
@@ -79,10 +90,11 @@ static void init_key_mappings(GameState* state) {
     array_push(state->key_mappings[QUIT].keys, KEY_ESCAPE);
 }
 
-static GameState* create_game_state(Arena* arena) {
+static GameState* create_game_state(Arena* arena, Arena* level_storage) {
     GameState* state = (GameState*)arena_alloc(arena, sizeof(GameState));
     *state = (GameState) {
         .fps_cap = false,
+        .level_storage = level_storage,
         .player_position = ivec2(0, 0),
         .tile_coords = create_array(21),
         .key_mappings = {
@@ -104,3 +116,6 @@ static GameState* create_game_state(Arena* arena) {
 }
 
 EXPORT_FN void game_update(GameState* game_state, RendererState* renderer_state, InputState* input_state, AudioState* audio_state);
+EXPORT_FN void game_level_enter(GameState* game_state);
+EXPORT_FN void game_level_exit(GameState* game_state);
+EXPORT_FN void game_level_update(GameState* game_state);
@@ -0,0 +1,270 @@
+/**
+ * @file hashmap.h
+ * @brief Arena-backed Robin Hood hash map and string interning.
+ */
+#pragma once
+#include "def.h"
+#include "arena.h"
+#include <string.h>
+
+// Keys carry their hash so it is computed once (e.g. at asset registration) rather than
+// on every lookup. String keys are not copied: intern them or make sure they outlive the map.
+typedef struct {
+    uint64 hash;
+    const char* str;    // nullptr for integer keys
+    usize len;          // String length, or the id itself for integer keys
+} HashKey;
+
+typedef struct {
+    HashKey key;        // key.hash == 0 marks an empty slot
+    uint64 value;
+} HashMapEntry;
+
+typedef struct {
+    Arena* arena;
+    HashMapEntry* entries;
+    usize capacity;     // Always a power of two
+    usize count;
+} HashMap;
+
+typedef struct {
+    HashMap map;
+    Arena* arena;
+} StringInterner;
+
+static inline uint64 hash_mix(uint64 x) {
+    // splitmix64 finalizer, a bijection so integer keys never collide on the full hash
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief Hashes a byte range 8 bytes at a time. Stable across runs and platforms
+ * (all supported targets are little-endian), so it can key on-disk data.
+ */
+uint64 hash_bytes(const void* data, usize size) {
+    const uint8* bytes = (const uint8*)data;
+    uint64 hash = 0x9e3779b97f4a7c15ull ^ (size * 0xff51afd7ed558ccdull);
+
+    usize i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64 word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = hash_mix(hash ^ word);
+    }
+
+    uint64 tail = 0;
+    for (usize shift = 0; i < size; i++, shift += 8) {
+        tail |= (uint64)bytes[i] << shift;
+    }
+
+    return hash_mix(hash ^ tail);
+}
+
+static inline uint64 hash_nonzero(uint64 hash) {
+    return hash ? hash : 1;
+}
+
+static inline HashKey hash_key_string(const char* str, usize len) {
+    return (HashKey){ .hash = hash_nonzero(hash_bytes(str, len)), .str = str, .len = len };
+}
+
+static inline HashKey hash_key_cstr(const char* str) {
+    return hash_key_string(str, strlen(str));
+}
+
+static inline HashKey hash_key_id(uint64 id) {
+    return (HashKey){ .hash = hash_nonzero(hash_mix(id)), .str = nullptr, .len = (usize)id };
+}
+
+static inline bool hash_key_equals(HashKey a, HashKey b) {
+    if (a.hash != b.hash || a.len != b.len) return false;
+    if (a.str == b.str) return true;
+    if (!a.str || !b.str) return false;
+    return memcmp(a.str, b.str, a.len) == 0;
+}
+
+HashMap create_hash_map(Arena* arena, usize capacity) {
+    usize power_of_two = 8;
+    while (power_of_two < capacity) power_of_two <<= 1;
+
+    HashMap map = {
+        .arena = arena,
+        .capacity = power_of_two,
+    };
+
+    map.entries = (HashMapEntry*)arena_alloc(arena, power_of_two * sizeof(HashMapEntry));
+    if (!map.entries) {
+        debug_print("Error: Arena out of memory for hash map (%zu entries)\n", power_of_two);
+        return (HashMap){};
+    }
+    memset(map.entries, 0, power_of_two * sizeof(HashMapEntry));
+    return map;
+}
+
+static inline usize hash_map_probe_distance(HashMap* map, uint64 hash, usize slot) {
+    return (slot - (usize)hash) & (map->capacity - 1);
+}
+
+// Robin Hood insert: an entry that is further from its home slot than the resident one
+// takes the slot, which keeps probe lengths short and lets lookups stop early.
+static void hash_map_insert_entry(HashMap* map, HashMapEntry entry) {
+    usize mask = map->capacity - 1;
+    usize slot = (usize)entry.key.hash & mask;
+    usize distance = 0;
+
+    for (;;) {
+        HashMapEntry* resident = &map->entries[slot];
+        if (resident->key.hash == 0) {
+            *resident = entry;
+            map->count++;
+            return;
+        }
+
+        usize resident_distance = hash_map_probe_distance(map, resident->key.hash, slot);
+        if (resident_distance < distance) {
+            HashMapEntry displaced = *resident;
+            *resident = entry;
+            entry = displaced;
+            distance = resident_distance;
+        }
+
+        slot = (slot + 1) & mask;
+        distance++;
+    }
+}
+
+static bool hash_map_grow(HashMap* map) {
+    HashMapEntry* old_entries = map->entries;
+    usize old_capacity = map->capacity;
+
+    // The old table is abandoned in the arena, size maps up front where that matters
+    HashMap grown = create_hash_map(map->arena, old_capacity * 2);
+    if (!grown.entries) return false;
+
+    for (usize i = 0; i < old_capacity; i++) {
+        if (old_entries[i].key.hash != 0) {
+            hash_map_insert_entry(&grown, old_entries[i]);
+        }
+    }
+
+    *map = grown;
+    return true;
+}
+
+static HashMapEntry* hash_map_find(HashMap* map, HashKey key) {
+    if (!map->entries) return nullptr;
+
+    usize mask = map->capacity - 1;
+    usize slot = (usize)key.hash & mask;
+
+    for (usize distance = 0; ; distance++) {
+        HashMapEntry* entry = &map->entries[slot];
+        // A resident closer to home than we are means the key would have displaced it
+        if (entry->key.hash == 0 || hash_map_probe_distance(map, entry->key.hash, slot) < distance) {
+            return nullptr;
+        }
+        if (hash_key_equals(entry->key, key)) {
+            return entry;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+bool hash_map_get(HashMap* map, HashKey key, uint64* value) {
+    HashMapEntry* entry = hash_map_find(map, key);
+    if (!entry) return false;
+    if (value) *value = entry->value;
+    return true;
+}
+
+/**
+ * @brief Inserts or overwrites `key`. Returns false only when the arena cannot grow the table.
+ */
+bool hash_map_put(HashMap* map, HashKey key, uint64 value) {
+    assert(key.hash != 0 && "Build hash keys with the hash_key_* helpers");
+
+    HashMapEntry* existing = hash_map_find(map, key);
+    if (existing) {
+        existing->value = value;
+        return true;
+    }
+
+    // Robin Hood stays fast up to high load, grow at 7/8
+    if ((map->count + 1) * 8 > map->capacity * 7 && !hash_map_grow(map)) {
+        return false;
+    }
+
+    hash_map_insert_entry(map, (HashMapEntry){ .key = key, .value = value });
+    return true;
+}
+
+bool hash_map_remove(HashMap* map, HashKey key) {
+    HashMapEntry* entry = hash_map_find(map, key);
+    if (!entry) return false;
+
+    // Backward shift deletion, no tombstones
+    usize mask = map->capacity - 1;
+    usize slot = (usize)(entry - map->entries);
+    for (;;) {
+        usize next = (slot + 1) & mask;
+        HashMapEntry* next_entry = &map->entries[next];
+        if (next_entry->key.hash == 0 || hash_map_probe_distance(map, next_entry->key.hash, next) == 0) {
+            break;
+        }
+        map->entries[slot] = *next_entry;
+        slot = next;
+    }
+
+    memset(&map->entries[slot], 0, sizeof(HashMapEntry));
+    map->count--;
+    return true;
+}
+
+void hash_map_clear(HashMap* map) {
+    memset(map->entries, 0, map->capacity * sizeof(HashMapEntry));
+    map->count = 0;
+}
+
+StringInterner create_string_interner(Arena* arena, usize capacity) {
+    return (StringInterner){
+        .map = create_hash_map(arena, capacity),
+        .arena = arena,
+    };
+}
+
+/**
+ * @brief Returns the unique, arena-owned copy of `str`. Equal strings intern to the same
+ * pointer, so interned strings can be compared by address.
+ */
+HashKey intern_string(StringInterner* interner, const char* str, usize len) {
+    HashKey key = hash_key_string(str, len);
+
+    uint64 interned;
+    if (hash_map_get(&interner->map, key, &interned)) {
+        key.str = (const char*)(uintptr_t)interned;
+        return key;
+    }
+
+    char* copy = (char*)arena_alloc(interner->arena, len + 1);
+    if (!copy) {
+        debug_print("Error: Arena out of memory interning string\n");
+        return (HashKey){};
+    }
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    key.str = copy;
+    if (!hash_map_put(&interner->map, key, (uint64)(uintptr_t)copy)) {
+        return (HashKey){};
+    }
+    return key;
+}
+
+HashKey intern_cstr(StringInterner* interner, const char* str) {
+    return intern_string(interner, str, strlen(str));
+}
@@ -0,0 +1,67 @@
+/**
+ * @file job.h
+ * @brief Fork-join parallel loops for load-time work such as decoding and resampling.
+ *
+ * Workers are started per call and joined before it returns, so there is no pool to manage.
+ * That costs tens of microseconds per call, fine for work measured in milliseconds.
+ */
+#pragma once
+#include "def.h"
+#include "arena.h"
+#include "thread.h"
+#include <stdatomic.h>
+
+constexpr int JOB_MAX_WORKERS = 15;
+
+typedef void JobFn(void* data, usize job_index);
+
+typedef struct {
+    JobFn* fn;
+    void* data;
+    usize job_count;
+    _Atomic(usize) next_job;
+} JobBatch;
+
+static void job_batch_drain(JobBatch* batch) {
+    for (;;) {
+        usize job = atomic_fetch_add(&batch->next_job, 1);
+        if (job >= batch->job_count) return;
+        batch->fn(batch->data, job);
+    }
+}
+
+static void job_worker_proc(void* data) {
+    job_batch_drain((JobBatch*)data);
+    // Workers only live for one call, jobs may have borrowed scratch arenas
+    scratch_thread_cleanup();
+}
+
+/**
+ * @brief Runs `fn(data, i)` for every i in [0, job_count) on worker threads and the calling
+ * thread, and returns once all of them finished. Jobs must not depend on each other.
+ * Jobs may use scratch_begin, each thread has its own scratch arenas.
+ */
+void job_run(JobFn* fn, void* data, usize job_count) {
+    JobBatch batch = {
+        .fn = fn,
+        .data = data,
+        .job_count = job_count,
+    };
+    atomic_store(&batch.next_job, 0);
+
+    // The calling thread is one of the workers
+    usize worker_count = MIN((usize)thread_hardware_concurrency() - 1, (usize)JOB_MAX_WORKERS);
+    worker_count = MIN(worker_count, job_count > 0 ? job_count - 1 : 0);
+
+    Thread workers[JOB_MAX_WORKERS];
+    usize started = 0;
+    for (; started < worker_count; started++) {
+        if (!thread_create(&workers[started], job_worker_proc, &batch)) break;
+    }
+
+    job_batch_drain(&batch);
+
+    for (usize i = 0; i < started; i++) {
+        thread_join(&workers[i]);
+    }
+}
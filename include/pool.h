@@ -0,0 +1,165 @@
+/**
+ * @file pool.h
+ * @brief Fixed-size block allocator with an intrusive free list, carved out of an Arena.
+ */
+#pragma once
+#include "def.h"
+#include "arena.h"
+
+#include <string.h>
+
+constexpr usize CACHE_LINE_SIZE = 64;
+
+typedef struct PoolFreeNode {
+    struct PoolFreeNode* next;
+} PoolFreeNode;
+
+typedef struct {
+    uint32 index;
+    uint32 generation;
+} PoolHandle;
+
+typedef struct {
+    uint8* blocks;
+    uint32* generations;        // Optional, odd while a block is live, bumped on every alloc/free
+    PoolFreeNode* free_list;    // Freed blocks, linked through their own storage
+    usize block_size;           // Stride between blocks, a multiple of CACHE_LINE_SIZE
+    usize capacity;
+    usize next_unused;          // Blocks past this index were never handed out
+    usize count;                // Blocks currently in use
+} Pool;
+
+/**
+ * @brief Reserves `capacity` cache-line-aligned blocks of at least `element_size` bytes.
+ *
+ * Blocks are handed out past `next_unused` before the free list grows, so pages of the
+ * backing arena are only touched as the pool actually fills up.
+ */
+Pool create_pool(Arena* arena, usize element_size, usize capacity, bool with_generations) {
+    Pool pool = {
+        .block_size = arena_align_up(element_size < sizeof(PoolFreeNode) ? sizeof(PoolFreeNode) : element_size,
+                                     CACHE_LINE_SIZE),
+        .capacity = capacity,
+    };
+
+    pool.blocks = (uint8*)arena_alloc_aligned(arena, pool.block_size * capacity, CACHE_LINE_SIZE);
+    if (!pool.blocks) {
+        debug_print("Error: Arena out of memory for pool (%zu blocks of %zu bytes)\n",
+                   capacity, pool.block_size);
+        return (Pool){};
+    }
+
+    if (with_generations) {
+        pool.generations = (uint32*)arena_alloc(arena, capacity * sizeof(uint32));
+        if (!pool.generations) {
+            debug_print("Error: Arena out of memory for pool generations\n");
+            return (Pool){};
+        }
+        memset(pool.generations, 0, capacity * sizeof(uint32));
+    }
+
+    return pool;
+}
+
+#define create_pool_for(arena, T, capacity, with_generations) \
+    create_pool((arena), sizeof(T), (capacity), (with_generations))
+
+static inline usize pool_index_of(Pool* pool, void* block) {
+    assert((uint8*)block >= pool->blocks && "Block does not belong to this pool");
+    usize index = (usize)((uint8*)block - pool->blocks) / pool->block_size;
+    assert(index < pool->capacity && "Block does not belong to this pool");
+    return index;
+}
+
+static inline void* pool_get(Pool* pool, usize index) {
+    assert(index < pool->capacity && "Pool index out of bounds");
+    return pool->blocks + index * pool->block_size;
+}
+
+/**
+ * @brief Takes a block off the pool in O(1). Returns nullptr when the pool is full.
+ * The block contents are left as they were, use pool_new for a zeroed typed block.
+ */
+void* pool_alloc(Pool* pool) {
+    void* block = nullptr;
+
+    if (pool->free_list) {
+        block = pool->free_list;
+        pool->free_list = pool->free_list->next;
+    } else if (pool->next_unused < pool->capacity) {
+        block = pool_get(pool, pool->next_unused++);
+    } else {
+        return nullptr;
+    }
+
+    if (pool->generations) {
+        uint32* generation = &pool->generations[pool_index_of(pool, block)];
+        assert((*generation & 1) == 0 && "Pool block handed out twice");
+        (*generation)++;
+    }
+
+    pool->count++;
+    return block;
+}
+
+void pool_free(Pool* pool, void* block) {
+    if (!block) return;
+
+    if (pool->generations) {
+        uint32* generation = &pool->generations[pool_index_of(pool, block)];
+        assert((*generation & 1) == 1 && "Pool block freed twice");
+        (*generation)++;
+    }
+
+    PoolFreeNode* node = (PoolFreeNode*)block;
+    node->next = pool->free_list;
+    pool->free_list = node;
+    pool->count--;
+}
+
+/**
+ * @brief pool_alloc with the first `size` bytes zeroed, pool_new is the typed form.
+ */
+static inline void* pool_alloc_zeroed(Pool* pool, usize size) {
+    assert(size <= pool->block_size && "Type does not fit in pool block");
+    void* block = pool_alloc(pool);
+    if (block) memset(block, 0, size);
+    return block;
+}
+
+#define pool_new(pool, T) ((T*)pool_alloc_zeroed((pool), sizeof(T)))
+
+/**
+ * @brief Drops every block at once, generations keep counting so old handles stay stale.
+ */
+void pool_reset(Pool* pool) {
+    if (pool->generations) {
+        for (usize i = 0; i < pool->next_unused; i++) {
+            pool->generations[i] += pool->generations[i] & 1;
+        }
+    }
+    pool->free_list = nullptr;
+    pool->next_unused = 0;
+    pool->count = 0;
+}
+
+/**
+ * @brief Makes a handle that can detect the block being freed and reused.
+ * Needs a pool created with generations.
+ */
+PoolHandle pool_handle(Pool* pool, void* block) {
+    assert(pool->generations && "Pool handles need a pool created with generations");
+    usize index = pool_index_of(pool, block);
+    return (PoolHandle){ .index = (uint32)index, .generation = pool->generations[index] };
+}
+
+/**
+ * @brief Resolves a handle, returning nullptr if its block was freed since.
+ */
+void* pool_from_handle(Pool* pool, PoolHandle handle) {
+    assert(pool->generations && "Pool handles need a pool created with generations");
+    if (handle.index >= pool->next_unused || pool->generations[handle.index] != handle.generation) {
+        return nullptr;
+    }
+    return pool_get(pool, handle.index);
+}
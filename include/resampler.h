@@ -0,0 +1,375 @@
+/**
+ * @file resampler.h
+ * @brief Sample rate conversion: a block-based streaming converter with linear and
+ * windowed-sinc modes, and an offline linear converter for whole buffers.
+ *
+ * Streaming input is pushed in arbitrary chunks into planar per-channel buffers, output is
+ * pulled as interleaved frames. The Q32.32 read position and the last few input frames are
+ * carried across chunks, so a stream resampled chunk by chunk matches the same data
+ * resampled in one go.
+ */
+#pragma once
+#include "def.h"
+#include "arena.h"
+#include "audio_mix.h"
+
+typedef enum {
+    RESAMPLE_LINEAR = 0,    // Two-tap interpolation, cheap
+    RESAMPLE_SINC   = 1,    // Blackman-windowed sinc polyphase filter, band-limited
+} ResampleQuality;
+
+constexpr int RESAMPLER_MAX_CHANNELS = 8;
+constexpr int RESAMPLER_SINC_TAPS = 16;
+constexpr int RESAMPLER_SINC_PHASE_BITS = 9;
+constexpr int RESAMPLER_SINC_PHASES = 1 << RESAMPLER_SINC_PHASE_BITS;
+
+typedef struct {
+    ResampleQuality quality;
+    int channels;
+    uint64 step;                            // Input frames per output frame, Q32.32
+    uint64 position;                        // Read position into the channel buffers, Q32.32
+    int16* coefficients;                    // Q15, RESAMPLER_SINC_PHASES rows of RESAMPLER_SINC_TAPS
+    int16* buffers[RESAMPLER_MAX_CHANNELS]; // Planar input, kept history first
+    usize capacity;                         // Frames per channel buffer
+    usize buffered;                         // Frames per channel buffer holding input
+    usize taps_before;                      // Input frames the filter reads before the position
+    usize taps_after;                       // ...and from the position on
+} Resampler;
+
+// Builds one row of filter taps per fractional phase. Each row is normalized to exactly
+// unity DC gain in Q15, so resampling never changes the level of the signal.
+static void resampler_build_sinc(int16* table, real64 cutoff) {
+    constexpr int center = RESAMPLER_SINC_TAPS / 2 - 1;
+
+    for (int phase = 0; phase < RESAMPLER_SINC_PHASES; phase++) {
+        real64 frac = (real64)phase / RESAMPLER_SINC_PHASES;
+        real64 taps[RESAMPLER_SINC_TAPS];
+        real64 sum = 0.0;
+
+        for (int k = 0; k < RESAMPLER_SINC_TAPS; k++) {
+            real64 t = (real64)(k - center) - frac;
+            real64 x = 2.0 * cutoff * t;
+            real64 sinc = fabs(x) < 1e-9 ? 1.0 : sin(PI * x) / (PI * x);
+
+            real64 w = (t + RESAMPLER_SINC_TAPS / 2.0) / RESAMPLER_SINC_TAPS;
+            real64 window = 0.42 - 0.5 * cos(2.0 * PI * w) + 0.08 * cos(4.0 * PI * w);
+
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+
+        int16* row = table + phase * RESAMPLER_SINC_TAPS;
+        int32 total = 0;
+        for (int k = 0; k < RESAMPLER_SINC_TAPS; k++) {
+            row[k] = (int16)lrint(taps[k] / sum * 32768.0);
+            total += row[k];
+        }
+        // Rounding error goes into the tap nearest the read position
+        row[frac < 0.5 ? center : center + 1] += (int16)(32768 - total);
+    }
+}
+
+// Linear interpolation with Q14 weights that sum to exactly 16384: s0 * w0 + s1 * w1 fits
+// pmaddwd, so the scalar and SIMD paths agree bit for bit
+static inline int16 resample_lerp_s16(int16 s0, int16 s1, uint32 frac) {
+    int32 w1 = (int32)(frac >> 18);
+    int32 w0 = 16384 - w1;
+    return (int16)(((int32)s0 * w0 + (int32)s1 * w1) >> 14);
+}
+
+static inline int32 resample_dot_s16_scalar(const int16* samples, const int16* taps) {
+    int32 sum = 0;
+    for (int k = 0; k < RESAMPLER_SINC_TAPS; k++) {
+        sum += (int32)samples[k] * taps[k];
+    }
+    return sum;
+}
+
+static inline int32 resample_dot_s16(const int16* samples, const int16* taps) {
+#if AUDIO_MIX_AVX2
+    __m256i products = _mm256_madd_epi16(
+        _mm256_loadu_si256((const __m256i*)samples),
+        _mm256_loadu_si256((const __m256i*)taps)
+    );
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(products), _mm256_extracti128_si256(products, 1));
+#elif AUDIO_MIX_SSE2
+    __m128i sum = _mm_add_epi32(
+        _mm_madd_epi16(_mm_loadu_si128((const __m128i*)samples), _mm_loadu_si128((const __m128i*)taps)),
+        _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(samples + 8)), _mm_loadu_si128((const __m128i*)(taps + 8)))
+    );
+#endif
+
+#if AUDIO_MIX_SSE2
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+#else
+    return resample_dot_s16_scalar(samples, taps);
+#endif
+}
+
+/**
+ * @brief Empties the resampler, e.g. when its stream seeks. Filter state is zeroed.
+ */
+void resampler_reset(Resampler* resampler) {
+    for (int ch = 0; ch < resampler->channels; ch++) {
+        memset(resampler->buffers[ch], 0, resampler->taps_before * sizeof(int16));
+    }
+    resampler->buffered = resampler->taps_before;
+    resampler->position = (uint64)resampler->taps_before << 32;
+}
+
+/**
+ * @brief Sets up a converter that accepts up to `max_input_frames` per push.
+ */
+bool resampler_init(
+    Resampler* resampler,
+    Arena* arena,
+    int channels,
+    int input_rate,
+    int output_rate,
+    ResampleQuality quality,
+    usize max_input_frames
+) {
+    assert(channels > 0 && channels <= RESAMPLER_MAX_CHANNELS && "Unsupported channel count");
+    assert(input_rate > 0 && output_rate > 0);
+
+    *resampler = (Resampler){
+        .quality = quality,
+        .channels = channels,
+        .step = ((uint64)input_rate << 32) / (uint64)output_rate,
+        .taps_before = quality == RESAMPLE_SINC ? RESAMPLER_SINC_TAPS / 2 - 1 : 0,
+        .taps_after = quality == RESAMPLE_SINC ? RESAMPLER_SINC_TAPS / 2 : 1,
+    };
+
+    // History, one push, and the tail appended by resampler_flush
+    resampler->capacity = resampler->taps_before + max_input_frames + resampler->taps_after + 1;
+    for (int ch = 0; ch < channels; ch++) {
+        resampler->buffers[ch] = arena_alloc(arena, resampler->capacity * sizeof(int16));
+        if (!resampler->buffers[ch]) {
+            debug_print("Error: Arena out of memory for resampler buffers\n");
+            return false;
+        }
+    }
+
+    if (quality == RESAMPLE_SINC) {
+        resampler->coefficients = arena_alloc_aligned(
+            arena,
+            RESAMPLER_SINC_PHASES * RESAMPLER_SINC_TAPS * sizeof(int16),
+            32
+        );
+        if (!resampler->coefficients) {
+            debug_print("Error: Arena out of memory for resampler coefficients\n");
+            return false;
+        }
+        // Downsampling lowers the cutoff below the output Nyquist, leaving room for the transition band
+        real64 cutoff = 0.46 * MIN(1.0, (real64)output_rate / (real64)input_rate);
+        resampler_build_sinc(resampler->coefficients, cutoff);
+    }
+
+    resampler_reset(resampler);
+    return true;
+}
+
+/**
+ * @brief Planar spans the next input can be written to directly (e.g. by
+ * stb_vorbis_get_samples_short). Returns how many frames fit, commit what was written.
+ */
+usize resampler_input_spans(Resampler* resampler, int16** spans) {
+    for (int ch = 0; ch < resampler->channels; ch++) {
+        spans[ch] = resampler->buffers[ch] + resampler->buffered;
+    }
+    return resampler->capacity - resampler->taps_after - resampler->buffered;
+}
+
+void resampler_commit(Resampler* resampler, usize frames) {
+    assert(resampler->buffered + frames + resampler->taps_after <= resampler->capacity);
+    resampler->buffered += frames;
+}
+
+/**
+ * @brief Deinterleaves up to `frames` input frames, returns how many were taken.
+ */
+usize resampler_push(Resampler* resampler, const int16* input, usize frames) {
+    int16* spans[RESAMPLER_MAX_CHANNELS];
+    usize count = MIN(frames, resampler_input_spans(resampler, spans));
+    int channels = resampler->channels;
+
+    for (usize i = 0; i < count; i++) {
+        for (int ch = 0; ch < channels; ch++) {
+            spans[ch][i] = input[i * channels + ch];
+        }
+    }
+
+    resampler_commit(resampler, count);
+    return count;
+}
+
+/**
+ * @brief Marks the end of the input: repeats the last frame for the tail the filter needs,
+ * so the following pulls drain every remaining output frame. Output past the last input
+ * frame holds its value, as resample_linear_range clamps to it.
+ */
+void resampler_flush(Resampler* resampler) {
+    for (int ch = 0; ch < resampler->channels; ch++) {
+        int16* buffer = resampler->buffers[ch];
+        int16 last = resampler->buffered > 0 ? buffer[resampler->buffered - 1] : 0;
+        for (usize i = 0; i < resampler->taps_after; i++) {
+            buffer[resampler->buffered + i] = last;
+        }
+    }
+    resampler->buffered += resampler->taps_after;
+}
+
+/**
+ * @brief Writes up to `max_frames` interleaved output frames, as many as the buffered input
+ * allows, then drops the input no later output depends on.
+ */
+usize resampler_pull(Resampler* resampler, int16* output, usize max_frames) {
+    int channels = resampler->channels;
+    usize produced = 0;
+
+    while (produced < max_frames) {
+        usize base = (usize)(resampler->position >> 32);
+        if (base + resampler->taps_after >= resampler->buffered) break;
+
+        uint32 frac = (uint32)resampler->position;
+        int16* frame = output + produced * channels;
+
+        if (resampler->quality == RESAMPLE_SINC) {
+            const int16* taps = resampler->coefficients +
+                                (frac >> (32 - RESAMPLER_SINC_PHASE_BITS)) * RESAMPLER_SINC_TAPS;
+            for (int ch = 0; ch < channels; ch++) {
+                int32 sum = resample_dot_s16(resampler->buffers[ch] + base - resampler->taps_before, taps);
+                frame[ch] = (int16)CLAMP((sum + (1 << 14)) >> 15, -32768, 32767);
+            }
+        } else {
+            for (int ch = 0; ch < channels; ch++) {
+                frame[ch] = resample_lerp_s16(resampler->buffers[ch][base], resampler->buffers[ch][base + 1], frac);
+            }
+        }
+
+        resampler->position += resampler->step;
+        produced++;
+    }
+
+    // Keep only the history the filter still reaches back into
+    usize base = (usize)(resampler->position >> 32);
+    usize drop = MIN(base - MIN(base, resampler->taps_before), resampler->buffered);
+    if (drop > 0) {
+        usize keep = resampler->buffered - drop;
+        for (int ch = 0; ch < channels; ch++) {
+            memmove(resampler->buffers[ch], resampler->buffers[ch] + drop, keep * sizeof(int16));
+        }
+        resampler->buffered = keep;
+        resampler->position -= (uint64)drop << 32;
+    }
+
+    return produced;
+}
+
+/**
+ * @brief Output length of an offline conversion, rounded to the nearest frame.
+ */
+static inline usize resample_output_frames(usize input_frames, int input_rate, int output_rate) {
+    return (usize)(((uint64)input_frames * (uint64)output_rate + (uint64)input_rate / 2) / (uint64)input_rate);
+}
+
+static inline uint64 resample_step(int input_rate, int output_rate) {
+    return ((uint64)input_rate << 32) / (uint64)output_rate;
+}
+
+// Scalar reference for resample_linear_range, also handles the last frames where the
+// right-hand neighbour is clamped to the end of the input
+static void resample_linear_range_scalar(
+    const int16* input,
+    usize input_frames,
+    int channels,
+    uint64 step,
+    int16* output,
+    usize first,
+    usize count
+) {
+    for (usize i = first; i < first + count; i++) {
+        uint64 position = (uint64)i * step;
+        usize index0 = MIN((usize)(position >> 32), input_frames - 1);
+        usize index1 = MIN(index0 + 1, input_frames - 1);
+
+        for (int ch = 0; ch < channels; ch++) {
+            output[i * channels + ch] = resample_lerp_s16(
+                input[index0 * channels + ch],
+                input[index1 * channels + ch],
+                (uint32)position
+            );
+        }
+    }
+}
+
+#if AUDIO_MIX_SSE2
+// Two stereo frames, each next to its right-hand neighbour: [La0, Ra0, La1, Ra1, Lb0, ...]
+static inline __m128i resample_stereo_pairs_sse2(const int16* input, usize index_a, usize index_b) {
+    return _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i*)(input + index_a * 2)),
+        _mm_loadl_epi64((const __m128i*)(input + index_b * 2))
+    );
+}
+
+// [L0, R0, L1, R1] -> [L0, L1, R0, R1] per frame, so one pmaddwd against [w0, w1, w0, w1]
+// gives both channels
+#define RESAMPLE_PAIR_SHUFFLE _MM_SHUFFLE(3, 1, 2, 0)
+#endif
+
+/**
+ * @brief Offline linear resampling of output frames [first, first + count). Output frame i
+ * reads input position i * step exactly, so any split of the output (across calls or
+ * threads) gives bit-identical results.
+ */
+void resample_linear_range(
+    const int16* input,
+    usize input_frames,
+    int channels,
+    uint64 step,
+    int16* output,
+    usize first,
+    usize count
+) {
+    usize i = first;
+    usize end = first + count;
+
+#if AUDIO_MIX_SSE2
+    if (channels == 2 && i + 4 <= end) {
+        // The fraction of i * step is the low half of i * (uint32)step, so four of them step
+        // together in 32-bit lanes and wrap exactly as the full positions do
+        uint64 position = (uint64)i * step;
+        __m128i frac = _mm_setr_epi32(
+            (int32)(uint32)position,
+            (int32)(uint32)(position + step),
+            (int32)(uint32)(position + 2 * step),
+            (int32)(uint32)(position + 3 * step)
+        );
+        __m128i frac_step = _mm_set1_epi32((int32)(uint32)(4 * step));
+        __m128i unity = _mm_set1_epi32(16384);
+
+        // Four frames per iteration while every right-hand neighbour is inside the input
+        for (; i + 4 <= end && ((position + 3 * step) >> 32) + 1 < input_frames; i += 4) {
+            __m128i w1 = _mm_srli_epi32(frac, 18);
+            __m128i weights = _mm_or_si128(_mm_sub_epi32(unity, w1), _mm_slli_epi32(w1, 16));
+
+            __m128i f01 = resample_stereo_pairs_sse2(input, (usize)(position >> 32), (usize)((position + step) >> 32));
+            __m128i f23 = resample_stereo_pairs_sse2(input, (usize)((position + 2 * step) >> 32), (usize)((position + 3 * step) >> 32));
+            f01 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(f01, RESAMPLE_PAIR_SHUFFLE), RESAMPLE_PAIR_SHUFFLE);
+            f23 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(f23, RESAMPLE_PAIR_SHUFFLE), RESAMPLE_PAIR_SHUFFLE);
+
+            __m128i lo = _mm_madd_epi16(f01, _mm_unpacklo_epi32(weights, weights));
+            __m128i hi = _mm_madd_epi16(f23, _mm_unpackhi_epi32(weights, weights));
+            __m128i packed = _mm_packs_epi32(_mm_srai_epi32(lo, 14), _mm_srai_epi32(hi, 14));
+            _mm_storeu_si128((__m128i*)(output + i * 2), packed);
+
+            position += 4 * step;
+            frac = _mm_add_epi32(frac, frac_step);
+        }
+    }
+#endif
+
+    resample_linear_range_scalar(input, input_frames, channels, step, output, i, end - i);
+}
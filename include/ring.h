@@ -0,0 +1,98 @@
+/**
+ * @file ring.h
+ * @brief Lock-free single-producer/single-consumer ring of fixed-size elements.
+ *
+ * The producer reserves a contiguous span, fills it in place and commits it; the consumer
+ * peeks a contiguous span, reads it in place and consumes it. No copies and no locks, as
+ * long as exactly one thread writes and one thread reads.
+ */
+#pragma once
+#include "def.h"
+#include "arena.h"
+#include <stdatomic.h>
+
+typedef struct {
+    uint8* data;
+    usize element_size;
+    usize capacity;                     // Elements, always a power of two
+
+    // Monotonic element counters, masked on access. Each side only writes its own counter,
+    // they sit on separate cache lines so the threads do not false-share.
+    alignas(64) _Atomic(usize) write_count;
+    alignas(64) _Atomic(usize) read_count;
+} SpscRing;
+
+/**
+ * @brief Allocates a ring of at least `capacity` elements from the arena.
+ */
+bool spsc_ring_init(SpscRing* ring, Arena* arena, usize element_size, usize capacity) {
+    usize power_of_two = 1;
+    while (power_of_two < capacity) power_of_two <<= 1;
+
+    ring->data = (uint8*)arena_alloc(arena, power_of_two * element_size);
+    if (!ring->data) {
+        debug_print("Error: Arena out of memory for ring (%zu elements)\n", power_of_two);
+        return false;
+    }
+
+    ring->element_size = element_size;
+    ring->capacity = power_of_two;
+    atomic_store(&ring->write_count, 0);
+    atomic_store(&ring->read_count, 0);
+    return true;
+}
+
+// Elements ready to read, from either side
+static inline usize spsc_ring_count(SpscRing* ring) {
+    return atomic_load_explicit(&ring->write_count, memory_order_acquire) -
+           atomic_load_explicit(&ring->read_count, memory_order_acquire);
+}
+
+/**
+ * @brief Producer: returns the contiguous free span at the write position, stops at the wrap.
+ */
+usize spsc_ring_reserve(SpscRing* ring, void** span) {
+    usize write = atomic_load_explicit(&ring->write_count, memory_order_relaxed);
+    usize read = atomic_load_explicit(&ring->read_count, memory_order_acquire);
+
+    usize offset = write & (ring->capacity - 1);
+    usize free = ring->capacity - (write - read);
+    *span = ring->data + offset * ring->element_size;
+    return MIN(free, ring->capacity - offset);
+}
+
+/**
+ * @brief Producer: publishes `count` elements written into the reserved span.
+ */
+void spsc_ring_commit(SpscRing* ring, usize count) {
+    usize write = atomic_load_explicit(&ring->write_count, memory_order_relaxed);
+    atomic_store_explicit(&ring->write_count, write + count, memory_order_release);
+}
+
+/**
+ * @brief Consumer: returns the contiguous readable span at the read position, stops at the wrap.
+ */
+usize spsc_ring_peek(SpscRing* ring, const void** span) {
+    usize read = atomic_load_explicit(&ring->read_count, memory_order_relaxed);
+    usize write = atomic_load_explicit(&ring->write_count, memory_order_acquire);
+
+    usize offset = read & (ring->capacity - 1);
+    *span = ring->data + offset * ring->element_size;
+    return MIN(write - read, ring->capacity - offset);
+}
+
+/**
+ * @brief Consumer: releases `count` elements back to the producer.
+ */
+void spsc_ring_consume(SpscRing* ring, usize count) {
+    usize read = atomic_load_explicit(&ring->read_count, memory_order_relaxed);
+    atomic_store_explicit(&ring->read_count, read + count, memory_order_release);
+}
+
+/**
+ * @brief Empties the ring. Only safe while neither side is using it.
+ */
+void spsc_ring_reset(SpscRing* ring) {
+    atomic_store(&ring->write_count, 0);
+    atomic_store(&ring->read_count, 0);
+}
@@ -0,0 +1,147 @@
+/**
+ * @file slotmap.h
+ * @brief Fixed-capacity slot map: dense values addressed through generational handles.
+ *
+ * Values are packed in `data[0, count)` for cache-friendly iteration, removal swaps the
+ * last value into the hole. Handles go through the sparse `slots` table, whose generation
+ * is bumped on every insert and remove so handles to removed values stop resolving.
+ * A zeroed slot map is a valid empty one.
+ */
+#pragma once
+#include "def.h"
+
+typedef struct {
+    uint32 index;
+    uint32 generation;      // 0 is never handed out, a zeroed handle is the null handle
+} SlotHandle;
+
+typedef struct {
+    uint32 dense_index;     // Position in data while live, next free slot + 1 while free
+    uint32 generation;      // Odd while live
+} SlotEntry;
+
+#define SLOT_MAP(T, N) struct { \
+    T data[N]; \
+    uint32 dense_to_slot[N]; \
+    SlotEntry slots[N]; \
+    usize count; \
+    uint32 free_head;       /* First free slot + 1, 0 when the free list is empty */ \
+    uint32 slots_used;      /* Slots past this were never handed out */ \
+}
+
+static inline bool slot_handle_is_null(SlotHandle handle) {
+    return handle.generation == 0;
+}
+
+static inline bool slot_handle_equals(SlotHandle a, SlotHandle b) {
+    return a.index == b.index && a.generation == b.generation;
+}
+
+// Takes a slot and points it at dense position `count`, the caller stores the value there
+static SlotHandle slot_map_acquire_slot(
+    SlotEntry* slots,
+    uint32* dense_to_slot,
+    usize count,
+    uint32* free_head,
+    uint32* slots_used
+) {
+    uint32 index;
+    if (*free_head) {
+        index = *free_head - 1;
+        *free_head = slots[index].dense_index;
+    } else {
+        index = (*slots_used)++;
+    }
+
+    SlotEntry* slot = &slots[index];
+    slot->generation++;
+    slot->dense_index = (uint32)count;
+    dense_to_slot[count] = index;
+
+    return (SlotHandle){ .index = index, .generation = slot->generation };
+}
+
+// Frees the handle's slot and re-points the slot of the value moved into its dense hole.
+// Returns the dense position the caller must fill with data[count - 1].
+static uint32 slot_map_release_slot(
+    SlotEntry* slots,
+    uint32* dense_to_slot,
+    usize count,
+    uint32* free_head,
+    SlotHandle handle
+) {
+    SlotEntry* slot = &slots[handle.index];
+    uint32 hole = slot->dense_index;
+    uint32 last = (uint32)count - 1;
+
+    uint32 moved_slot = dense_to_slot[last];
+    slots[moved_slot].dense_index = hole;
+    dense_to_slot[hole] = moved_slot;
+
+    slot->generation++;
+    slot->dense_index = *free_head;
+    *free_head = handle.index + 1;
+
+    return hole;
+}
+
+#define slot_map_cap(map) ARRAY_LEN((map).data)
+
+#define slot_map_len(map) ((map).count)
+
+#define slot_map_is_full(map) ((map).count >= slot_map_cap(map))
+
+#define slot_map_contains(map, handle) \
+    ((handle).index < slot_map_cap(map) && (handle).generation != 0 && \
+     (map).slots[(handle).index].generation == (handle).generation)
+
+/**
+ * Inserts `value` and returns its handle, or the null handle when the map is full.
+ */
+#define slot_map_insert(map, value) \
+    ({ \
+        SlotHandle handle = {}; \
+        if (!slot_map_is_full(map)) { \
+            handle = slot_map_acquire_slot((map).slots, (map).dense_to_slot, (map).count, \
+                                           &(map).free_head, &(map).slots_used); \
+            (map).data[(map).count++] = (value); \
+        } \
+        handle; \
+    })
+
+/**
+ * Resolves a handle to a pointer into the dense array, nullptr when stale.
+ * The pointer is only valid until the next removal.
+ */
+#define slot_map_get(map, handle) \
+    (slot_map_contains(map, handle) ? &(map).data[(map).slots[(handle).index].dense_index] : nullptr)
+
+#define slot_map_remove(map, handle) \
+    ({ \
+        bool removed = slot_map_contains(map, handle); \
+        if (removed) { \
+            uint32 hole = slot_map_release_slot((map).slots, (map).dense_to_slot, (map).count, \
+                                                &(map).free_head, (handle)); \
+            (map).data[hole] = (map).data[--(map).count]; \
+        } \
+        removed; \
+    })
+
+/**
+ * Handle of the value at dense position `dense_index`, for use while iterating `data`.
+ */
+#define slot_map_handle_at(map, dense_index) \
+    ((SlotHandle){ \
+        .index = (map).dense_to_slot[dense_index], \
+        .generation = (map).slots[(map).dense_to_slot[dense_index]].generation, \
+    })
+
+/**
+ * Removes every value, generations keep counting so outstanding handles stay stale.
+ */
+#define slot_map_clear(map) \
+    do { \
+        while ((map).count > 0) { \
+            slot_map_remove(map, slot_map_handle_at(map, (map).count - 1)); \
+        } \
+    } while(0)
@@ -0,0 +1,96 @@
+/**
+ * @file thread.h
+ * @brief Minimal cross-platform threads for engine workers (audio decoding, jobs).
+ */
+#pragma once
+#include "def.h"
+#include "utils.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+typedef void ThreadFn(void* data);
+
+typedef struct {
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    ThreadFn* fn;
+    void* data;
+    bool running;
+} Thread;
+
+#ifdef _WIN32
+static DWORD WINAPI thread_entry(LPVOID param) {
+    Thread* thread = (Thread*)param;
+    thread->fn(thread->data);
+    return 0;
+}
+#else
+static void* thread_entry(void* param) {
+    Thread* thread = (Thread*)param;
+    thread->fn(thread->data);
+    return nullptr;
+}
+#endif
+
+/**
+ * @brief Starts `fn(data)` on a new thread. `thread` must stay valid until thread_join.
+ */
+bool thread_create(Thread* thread, ThreadFn* fn, void* data) {
+    thread->fn = fn;
+    thread->data = data;
+
+#ifdef _WIN32
+    thread->handle = CreateThread(nullptr, 0, thread_entry, thread, 0, nullptr);
+    thread->running = thread->handle != nullptr;
+#else
+    thread->running = pthread_create(&thread->handle, nullptr, thread_entry, thread) == 0;
+#endif
+
+    if (!thread->running) {
+        debug_print("Error: Failed to create thread\n");
+    }
+    return thread->running;
+}
+
+void thread_join(Thread* thread) {
+    if (!thread->running) return;
+
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    thread->handle = nullptr;
+#else
+    pthread_join(thread->handle, nullptr);
+#endif
+    thread->running = false;
+}
+
+/**
+ * @brief Number of hardware threads, at least 1.
+ */
+static inline int thread_hardware_concurrency(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return MAX((int)info.dwNumberOfProcessors, 1);
+#else
+    return MAX((int)sysconf(_SC_NPROCESSORS_ONLN), 1);
+#endif
+}
+
+static inline void thread_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
@@ -8,7 +8,6 @@
 #include <windows.h>
 #include <stdint.h>
 #else
-#define __USE_POSIX199309
 #include <time.h>
 #include <unistd.h>
 #endif
@@ -83,9 +83,13 @@ static void* audio_thread_proc(void* param) {
     uint32 samples_per_buffer = frames_per_buffer * game->audio_channels;
     uint32 buffer_size = samples_per_buffer * sizeof(int16);
     
-    int16* audio_buffer = malloc(buffer_size);
+    // Lives for the whole thread, taken from this thread's scratch arena instead of the heap
+    ArenaTemp scratch = scratch_begin(nullptr, 0);
+    int16* audio_buffer = arena_alloc(scratch.arena, buffer_size);
     if (!audio_buffer) {
         debug_print("Error: Could not allocate audio buffer\n");
+        scratch_end(scratch);
+        scratch_thread_cleanup();
         return nullptr;
     }
     
@@ -103,13 +107,6 @@ static void* audio_thread_proc(void* param) {
                    (samples_per_buffer - samples_read) * sizeof(int16));
         }
         
-        // Apply volume
-        if (game->audio_volume != 1.0f) {
-            for (uint32 i = 0; i < samples_read; i++) {
-                audio_buffer[i] = (int16)((real32)audio_buffer[i] * game->audio_volume);
-            }
-        }
-        
         // Write to PulseAudio
         int error;
         if (pa_simple_write(global_audio_state.pulse_simple, audio_buffer, buffer_size, &error) < 0) {
@@ -118,14 +115,14 @@ static void* audio_thread_proc(void* param) {
         }
     }
     
-    free(audio_buffer);
+    scratch_end(scratch);
+    scratch_thread_cleanup();
     return nullptr;
 }
 
 void platform_audio_init(Game* game) {
     memset(&global_audio_state, 0, sizeof(global_audio_state));
     global_audio_state.game = game;
-    game->audio_volume = 1.0f;
     
     // Initialize ring buffer with 1 second capacity
     usize ring_buffer_capacity = game->audio_sample_rate * game->audio_channels;
@@ -213,7 +210,7 @@ void platform_audio_update_buffer(Game* game) {
 void platform_audio_set_volume(real32 volume) {
     if (volume < 0.0f) volume = 0.0f;
     if (volume > 1.0f) volume = 1.0f;
-    global_audio_state.game->audio_volume = volume;
+    audio_state->volume = volume;
 }
 
 void platform_audio_cleanup(void) {
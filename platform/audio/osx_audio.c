@@ -95,12 +95,6 @@ static void audio_callback(void* user_data, AudioQueueRef aq, AudioQueueBufferRe
         memset(audio_data + samples_read, 0, (total_samples - samples_read) * sizeof(int16));
     }
     
-    if (game->audio_volume != 1.0f) {
-        for (uint32 i = 0; i < samples_read; i++) {
-            audio_data[i] = (int16)((real32)audio_data[i] * game->audio_volume);
-        }
-    }
-
     buffer->mAudioDataByteSize = buffer_size;
     AudioQueueEnqueueBuffer(aq, buffer, 0, nullptr);
 }
@@ -108,7 +102,6 @@ static void audio_callback(void* user_data, AudioQueueRef aq, AudioQueueBufferRe
 void platform_audio_init(Game* game) {
     memset(&global_audio_state, 0, sizeof(global_audio_state));
     global_audio_state.game = game;
-    game->audio_volume = 1.0f;
 
     usize ring_buffer_capacity = game->audio_sample_rate * game->audio_channels;
     ring_buffer_init(&global_audio_state.ring_buffer, ring_buffer_capacity);
@@ -181,7 +174,7 @@ void platform_audio_update_buffer(Game* game) {
 void platform_audio_set_volume(real32 volume) {
     if (volume < 0.0f) volume = 0.0f;
     if (volume > 1.0f) volume = 1.0f;
-    global_audio_state.game->audio_volume = volume;
+    audio_state->volume = volume;
 }
 
 void platform_audio_cleanup(void) {
@@ -143,12 +143,6 @@ static DWORD WINAPI audio_thread_proc(LPVOID param) {
                 memset(audio_data + samples_read, 0,
                        (samples_in_region1 - samples_read) * sizeof(int16));
             }
-
-            if (audio_state->volume != 1.0f && samples_read > 0) {
-                for (uint32 i = 0; i < samples_read; i++) {
-                    audio_data[i] = (int16)((real32)audio_data[i] * audio_state->volume);
-                }
-            }
         }
 
         if (audio_ptr2 && audio_bytes2 > 0) {
@@ -165,12 +159,6 @@ static DWORD WINAPI audio_thread_proc(LPVOID param) {
                 memset(audio_data + samples_read, 0,
                        (samples_in_region2 - samples_read) * sizeof(int16));
             }
-
-            if (audio_state->volume != 1.0f && samples_read > 0) {
-                for (uint32 i = 0; i < samples_read; i++) {
-                    audio_data[i] = (int16)((real32)audio_data[i] * audio_state->volume);
-                }
-            }
         }
 
         IDirectSoundBuffer_Unlock(
@@ -121,16 +121,20 @@ void write_file(const char* path, const char* data, usize size) {
 }
 
 bool copy_file(Arena* arena, const char* src_path, const char* dst_path) {
+    bool success = false;
+    // The file contents are scratch, release them before returning
+    ArenaTemp temp = arena_temp_begin(arena);
+
     // Read source file
     char* data = read_entire_file(arena, src_path);
     if (!data) {
-        return false;
+        goto cleanup;
     }
     
     // Get source file size
     usize size = file_get_size(src_path);
     if (size == 0) {
-        return false;
+        goto cleanup;
     }
     
     // Write to destination
@@ -144,13 +148,16 @@ bool copy_file(Arena* arena, const char* src_path, const char* dst_path) {
         nullptr
     );
     if (dst_file == INVALID_HANDLE_VALUE) {
-        return false;
+        goto cleanup;
     }
     
     DWORD bytes_written;
-    bool success = WriteFile(dst_file, data, (DWORD)size, &bytes_written, nullptr) && 
-                   bytes_written == size;
+    success = WriteFile(dst_file, data, (DWORD)size, &bytes_written, nullptr) && 
+              bytes_written == size;
     
     CloseHandle(dst_file);
+
+cleanup:
+    arena_temp_end(temp);
     return success;
 }
\ No newline at end of file
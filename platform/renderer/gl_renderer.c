@@ -1,3 +1,4 @@
+#include "def.h" // Before glad, whose system headers must see its feature macros
 #include "glad/glad.h"
 #include "input.h"
 #define STB_IMAGE_IMPLEMENTATION
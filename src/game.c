@@ -27,8 +27,8 @@ static bool is_down(GameInputType type) {
 static Tile* get_tile(int x, int y) {
     Tile* tile = nullptr;
 
-    if (x >= 0 && x < WORLD_GRID.x && y >= 0 && y < WORLD_GRID.y) {
-        tile = &game_state->world_grid[x][y];
+    if (game_state->level && x >= 0 && x < WORLD_GRID.x && y >= 0 && y < WORLD_GRID.y) {
+        tile = &game_state->level->world_grid[x][y];
     }
 
     return tile;
@@ -42,6 +42,8 @@ static Tile* get_tile_iv2(IVec2 world_pos) {
 }
 
 static void draw_tileset() {
+    if (!game_state->level) { return; }
+
     static int neighbour_offsets[24] = {
         // Top      Left     Right    Bottom
            0,-1,    -1, 0,    1, 0,    0, 1,
@@ -99,6 +101,36 @@ static void draw_tileset() {
 }
 
 
+void game_level_enter(GameState* game_state_in) {
+    Level* level = (Level*)arena_alloc(game_state_in->level_storage, sizeof(Level));
+    assert(level != nullptr && "Level arena too small for Level");
+    memset(level, 0, sizeof(Level));
+    level->index = game_state_in->requested_level;
+
+    game_state_in->level = level;
+    debug_print("Entered level %u\n", level->index);
+}
+
+void game_level_exit(GameState* game_state_in) {
+    // Nothing entered yet, or the level was already exited
+    if (!game_state_in->level) return;
+
+    // Level memory goes away with the arena reset, only drop the references into it
+    debug_print("Exiting level %u\n", game_state_in->level->index);
+    game_state_in->level = nullptr;
+}
+
+void game_level_update(GameState* game_state_in) {
+    if (game_state_in->level && game_state_in->level->index == game_state_in->requested_level) {
+        return;
+    }
+
+    game_level_exit(game_state_in);
+    // Drops everything the previous level allocated and hands its pages back to the OS
+    arena_reset(game_state_in->level_storage);
+    game_level_enter(game_state_in);
+}
+
 void game_update(
     GameState* game_state_in,
     RendererState* renderer_state_in,
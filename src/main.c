@@ -22,7 +22,10 @@
 #include "game.h"
 
 typedef void GameUpdateFn(GameState*, RendererState*, InputState*, AudioState*);
+typedef void GameLevelFn(GameState*);
 static GameUpdateFn* game_update_ptr;
+static GameLevelFn* game_level_exit_ptr;
+static GameLevelFn* game_level_update_ptr;
 
 static void game_update(
     GameState* game_state,
@@ -46,6 +49,7 @@ static void reload_game_dll(Arena* transient_storage) {
             debug_print("Unloaded old game dynlib\n");
         }
 
+        // copy_file scopes its scratch, so retries don't pile dll copies up in the frame arena
         while (!copy_file(transient_storage, DYNLIB("game"), DYNLIB("game_load"))) {
             sleep_nanos(10 * NANOS_PER_MILLI);
         }
@@ -55,26 +59,96 @@ static void reload_game_dll(Arena* transient_storage) {
 
         game_update_ptr = (GameUpdateFn*)dynlib_get_symbol(game_dll, "game_update");
         assert(game_update_ptr != nullptr && "Failed to load update_game function");
+        game_level_exit_ptr = (GameLevelFn*)dynlib_get_symbol(game_dll, "game_level_exit");
+        assert(game_level_exit_ptr != nullptr && "Failed to load game_level_exit function");
+        game_level_update_ptr = (GameLevelFn*)dynlib_get_symbol(game_dll, "game_level_update");
+        assert(game_level_update_ptr != nullptr && "Failed to load game_level_update function");
         game_dll_timestamp = current_dll_timestamp;
     }
 }
 
-static void print_arena_stats(Arena* permanent_storage, Arena* transient_storage) {
+static void print_arena_stats(Arena* permanent_storage, Arena* level_storage, FrameArenas* frame_arenas) {
     debug_print("Arena statistics:\n");
     debug_print(
-        "  Permanent: %.1f/%.1f KB used (%.1f%%, %.1f KB remaining)\n",
+        "  Permanent: %.1f/%.1f KB used (%.1f%%, %.1f KB remaining, %.1f KB committed)\n",
         arena_get_used(permanent_storage) / 1024.0f,
         permanent_storage->size / 1024.0f,
         (real32)arena_get_used(permanent_storage) / permanent_storage->size * 100.0f,
-        arena_get_remaining(permanent_storage) / 1024.0f
+        arena_get_remaining(permanent_storage) / 1024.0f,
+        arena_get_committed(permanent_storage) / 1024.0f
     );
     debug_print(
-        "  Transient: %.1f/%.1f KB used (%.1f%%, %.1f KB remaining)\n",
-        arena_get_used(transient_storage) / 1024.0f,
-        transient_storage->size / 1024.0f,
-        (real32)arena_get_used(transient_storage) / transient_storage->size * 100.0f,
-        arena_get_remaining(transient_storage) / 1024.0f
+        "  Level: %.1f/%.1f KB used (%.1f KB committed)\n",
+        arena_get_used(level_storage) / 1024.0f,
+        level_storage->size / 1024.0f,
+        arena_get_committed(level_storage) / 1024.0f
     );
+    // The frame that just ended already reset its arena, so every arena of the ring is reported
+    for (int i = 0; i < FRAME_ARENA_COUNT; i++) {
+        Arena* transient_storage = &frame_arenas->arenas[i];
+        debug_print(
+            "  Transient %d: %.1f/%.1f KB used (%.1f KB committed, %u spill block(s) needed at peak)\n",
+            i,
+            arena_get_used(transient_storage) / 1024.0f,
+            transient_storage->size / 1024.0f,
+            arena_get_committed(transient_storage) / 1024.0f,
+            transient_storage->spill_peak
+        );
+    }
+
+#if ARENA_TELEMETRY
+    debug_print(
+        "  Permanent: %.1f KB high water, %llu allocations\n",
+        permanent_storage->stats.high_water / 1024.0f,
+        (unsigned long long)permanent_storage->stats.alloc_count
+    );
+    debug_print(
+        "  Level: %.1f KB high water over %llu level loads\n",
+        level_storage->stats.high_water / 1024.0f,
+        (unsigned long long)level_storage->stats.reset_count
+    );
+    for (int i = 0; i < FRAME_ARENA_COUNT; i++) {
+        Arena* transient_storage = &frame_arenas->arenas[i];
+        debug_print(
+            "  Transient %d: %.1f KB high water, %.1f KB max frame peak, %.1f KB last frame peak\n",
+            i,
+            transient_storage->stats.high_water / 1024.0f,
+            transient_storage->stats.max_frame_peak / 1024.0f,
+            transient_storage->stats.last_frame_peak / 1024.0f
+        );
+    }
+#endif
+}
+
+static void write_arena_report(Arena* permanent_storage, Arena* level_storage, FrameArenas* frame_arenas) {
+#if ARENA_TELEMETRY
+    static_assert(FRAME_ARENA_COUNT == 3, "Update the arena report names");
+    Arena* arenas[] = {
+        permanent_storage,
+        level_storage,
+        &frame_arenas->arenas[0],
+        &frame_arenas->arenas[1],
+        &frame_arenas->arenas[2],
+    };
+    const char* names[] = {"permanent", "level", "transient0", "transient1", "transient2"};
+
+    FILE* csv = fopen("arena_stats.csv", "w");
+    if (csv) {
+        arena_stats_write_csv(csv, arenas, names, ARRAY_LEN(arenas));
+        fclose(csv);
+    }
+
+    FILE* json = fopen("arena_stats.json", "w");
+    if (json) {
+        arena_stats_write_json(json, arenas, names, ARRAY_LEN(arenas));
+        fclose(json);
+    }
+    debug_print("Arena report written to arena_stats.csv and arena_stats.json\n");
+#else
+    (void)permanent_storage;
+    (void)level_storage;
+    (void)frame_arenas;
+#endif
 }
 
 int main(int argc, [[maybe_unused]] char* argv[argc + 1]) {
@@ -83,60 +157,94 @@ int main(int argc, [[maybe_unused]] char* argv[argc + 1]) {
     debug_print("  FPS: %d\n", FPS);
     debug_print("  Max audio sources: %d\n", MAX_AUDIO_SOURCES);
 
-    Arena permanent_storage = create_arena(MB(64));
-    Arena transient_storage = create_arena(MB(128));
-    debug_print("  Permanent arena: %.1f KB initialized\n", permanent_storage.size / 1024.0f);
-    debug_print("  Transient arena: %.1f KB initialized\n", transient_storage.size / 1024.0f);
+    // Both arenas only reserve address space, pages get committed as they are first used
+    Arena permanent_storage = create_arena_with_flags(MB(64), ARENA_FLAG_LARGE_PAGES);
+    // Growable so an oversized asset decode spills into extra blocks instead of failing.
+    // Each frame arena survives until its frame is retired, see FrameArenas
+    static FrameArenas frame_arenas;
+    frame_arenas_init(&frame_arenas, MB(128), ARENA_FLAG_GROWABLE);
+    Arena* transient_storage = frame_arena_current(&frame_arenas);
+    // Reset on every level change, decommitting keeps a small level from inheriting a big one's pages
+    Arena level_storage = create_arena_with_flags(MB(32), ARENA_FLAG_DECOMMIT_ON_RESET);
+    debug_print("  Permanent arena: %.1f KB reserved\n", permanent_storage.size / 1024.0f);
+    debug_print("  Level arena: %.1f KB reserved\n", level_storage.size / 1024.0f);
+    debug_print("  Transient arenas: %d x %.1f KB reserved\n", FRAME_ARENA_COUNT, transient_storage->size / 1024.0f);
 
     // TODO: Maybe check if these allocations succeed
     renderer_state = create_renderer_state(&permanent_storage);
-    game_state = create_game_state(&permanent_storage);
+    game_state = create_game_state(&permanent_storage, &level_storage);
     input_state = create_input_state(&permanent_storage);
     audio_state = create_audio_state(&permanent_storage);
 
     window_init("The game", 1280, 720);
     window_set_resizable(true);
     platform_audio_init();
+    audio_decoder_start(audio_state);
     renderer_init();
     renderer_set_vsync(true);
 
+#if __has_embed("assets/cooked/Background.pcm") && __has_embed("assets/cooked/Explosion.pcm")
+    // `make cook` output is already in the mixer's format, the sources play from the binary
+    alignas(64) static const uint8 background_pcm[] = {
+        #embed "assets/cooked/Background.pcm"
+    };
+    alignas(64) static const uint8 explosion_pcm[] = {
+        #embed "assets/cooked/Explosion.pcm"
+    };
+
+    AudioSourceHandle background_ogg = create_audio_source_static_cooked(
+        audio_state, background_pcm, sizeof(background_pcm), false);
+    AudioSourceHandle explosion_ogg = create_audio_source_static_cooked(
+        audio_state, explosion_pcm, sizeof(explosion_pcm), false);
+    if (slot_handle_is_null(background_ogg) || slot_handle_is_null(explosion_ogg)) {
+        debug_print("ERROR: Failed to load cooked sounds, run `make cook` again\n");
+        return -1;
+    }
+
+    // Cooked music plays through a voice, it outranks every effect so SFX never steal it
+    audio_source_set_priority(audio_state, background_ogg, UINT8_MAX);
+#else
     static uint8 background_ogg_source[] = {
         #embed "assets/sounds/Background.ogg"
     };
-    usize background_ogg_size = sizeof(background_ogg_source);
+    static uint8 explosion_ogg_source[] = {
+        #embed "assets/sounds/Explosion.ogg"
+    };
 
-    AudioSource* background_ogg = create_audio_source_static_memory(
+    // Music streams straight from the embedded OGG, only the look-ahead is ever decoded
+    AudioSourceHandle background_ogg = create_audio_source_streaming_memory(
         &permanent_storage,
         audio_state,
         background_ogg_source,
-        background_ogg_size,
+        sizeof(background_ogg_source),
+        STREAM_LOOKAHEAD_MS,
+        RESAMPLE_SINC,
         false
     );
-    if (!background_ogg) {
-        debug_print("ERROR: Failed to load background_ogg\n");
-        return -1;
-    }
-
-    background_ogg->volume = 0.5f;
-    audio_source_play(background_ogg);
 
-    static uint8 explosion_ogg_source[] = {
-        #embed "assets/sounds/Explosion.ogg"
-    };
-    usize explosion_ogg_size = sizeof(explosion_ogg_source);
-
-    AudioSource* explosion_ogg = create_audio_source_static_memory(
+    // Decoded samples persist in the per-user cache, only the first launch decodes
+    audio_sample_cache_enable_disk(audio_state, nullptr);
+    AudioSourceHandle explosion_ogg = create_audio_source_static_memory(
         &permanent_storage,
+        transient_storage,
         audio_state,
         explosion_ogg_source,
-        explosion_ogg_size,
-        false
+        sizeof(explosion_ogg_source),
+        false,
+        AUDIO_DECODE_RANGES_SERIAL
     );
-    if (!explosion_ogg) {
-        debug_print("ERROR: Failed to load explosion_ogg\n");
+
+    if (slot_handle_is_null(background_ogg) || slot_handle_is_null(explosion_ogg)) {
+        debug_print("ERROR: Failed to load sounds\n");
         return -1;
     }
-    explosion_ogg->volume = 0.3f;
+#endif
+
+    audio_source_set_volume(audio_state, background_ogg, 0.5f);
+    audio_source_play(audio_state, background_ogg);
+
+    audio_source_set_volume(audio_state, explosion_ogg, 0.3f);
+    audio_source_set_voice_limit(audio_state, explosion_ogg, 8);
 
     const uint64 NANOS_PER_UPDATE = NANOS_PER_SEC / FPS;
     uint64 accumulator = 0;
@@ -153,11 +261,13 @@ int main(int argc, [[maybe_unused]] char* argv[argc + 1]) {
         last_time = current_time;
         accumulator += delta_time;
 
-        reload_game_dll(&transient_storage);
+        reload_game_dll(transient_storage);
+        game_level_update_ptr(game_state);
 
         window_poll_events();
 
         while (accumulator >= NANOS_PER_UPDATE) {
+            audio_state_update(audio_state);
             platform_audio_update_buffer();
             
             if (game_state->fps_cap) {
@@ -175,13 +285,26 @@ int main(int argc, [[maybe_unused]] char* argv[argc + 1]) {
             window_present();
         }
 
-        arena_reset(&transient_storage);
+        // Rendering is still synchronous, so nothing reads this frame's data past this point.
+        // A render/upload thread would retire the frame itself once it is done with it
+        frame_arenas_retire(&frame_arenas, frame_arenas.frame_index);
+        frame_arenas_advance(&frame_arenas);
+        transient_storage = frame_arena_current(&frame_arenas);
+    }
+
+    if (game_state->level) {
+        game_level_exit_ptr(game_state);
     }
+    print_arena_stats(&permanent_storage, &level_storage, &frame_arenas);
+    write_arena_report(&permanent_storage, &level_storage, &frame_arenas);
 
     platform_audio_cleanup();
+    audio_decoder_stop(audio_state);
+    audio_state_cleanup(audio_state);
     window_cleanup();
     renderer_cleanup();
-    arena_cleanup(&transient_storage);
+    frame_arenas_cleanup(&frame_arenas);
+    arena_cleanup(&level_storage);
     arena_cleanup(&permanent_storage);
 
     return EXIT_SUCCESS;
@@ -0,0 +1,164 @@
+/**
+ * @file bench_arena.c
+ * @brief Compares the reserving arena against the old malloc arena: startup time, resident
+ * size and first-touch page faults for the engine's arena layout.
+ *
+ * Every variant runs in a forked child so its RSS and fault counts start from the same base.
+ * Usage: bench_arena. Run through `make bench RELEASE=1`.
+ */
+#include "def.h"
+#include "arena.h"
+#include "utils.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+// The baseline arena: one malloc of the whole size, nothing given back until cleanup
+typedef struct {
+    uint8* memory;
+    usize size;
+    usize offset;
+} MallocArena;
+
+typedef enum {
+    BENCH_ARENA_MALLOC,
+    BENCH_ARENA_RESERVE,
+    BENCH_ARENA_LARGE_PAGES,
+    BENCH_ARENA_DECOMMIT,
+} BenchArenaKind;
+
+typedef struct {
+    BenchArenaKind kind;
+    Arena arena;
+    MallocArena malloc_arena;
+} BenchArena;
+
+static const char* bench_arena_names[] = {"malloc", "reserve", "reserve+large", "reserve+decommit"};
+
+static BenchArena bench_arena_create(BenchArenaKind kind, usize size, bool permanent) {
+    BenchArena bench = { .kind = kind };
+    switch (kind) {
+        case BENCH_ARENA_MALLOC:
+            bench.malloc_arena = (MallocArena){ .memory = (uint8*)malloc(size), .size = size };
+            break;
+        case BENCH_ARENA_RESERVE:
+            bench.arena = create_arena(size);
+            break;
+        case BENCH_ARENA_LARGE_PAGES:
+            // Only the permanent tier takes large pages in main.c
+            bench.arena = create_arena_with_flags(size, permanent ? ARENA_FLAG_LARGE_PAGES : ARENA_FLAG_NONE);
+            break;
+        case BENCH_ARENA_DECOMMIT:
+            bench.arena = create_arena_with_flags(size, permanent ? ARENA_FLAG_NONE : ARENA_FLAG_DECOMMIT_ON_RESET);
+            break;
+    }
+    return bench;
+}
+
+static uint8* bench_arena_alloc(BenchArena* bench, usize size) {
+    if (bench->kind != BENCH_ARENA_MALLOC) {
+        return (uint8*)arena_alloc(&bench->arena, size);
+    }
+    MallocArena* arena = &bench->malloc_arena;
+    if (arena->offset + size > arena->size) return nullptr;
+    uint8* ptr = arena->memory + arena->offset;
+    arena->offset += (size + 7) & ~(usize)7;
+    return ptr;
+}
+
+static void bench_arena_reset(BenchArena* bench) {
+    if (bench->kind == BENCH_ARENA_MALLOC) {
+        bench->malloc_arena.offset = 0;
+    } else {
+        arena_reset(&bench->arena);
+    }
+}
+
+static void bench_arena_cleanup(BenchArena* bench) {
+    if (bench->kind == BENCH_ARENA_MALLOC) {
+        free(bench->malloc_arena.memory);
+    } else {
+        arena_cleanup(&bench->arena);
+    }
+}
+
+static usize bench_resident_bytes(void) {
+    usize pages = 0, resident = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    if (fscanf(statm, "%zu %zu", &pages, &resident) != 2) resident = 0;
+    fclose(statm);
+    return resident * (usize)sysconf(_SC_PAGESIZE);
+}
+
+static long bench_minor_faults(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+static void bench_touch(uint8* memory, usize size) {
+    for (usize i = 0; i < size; i += KB(4)) memory[i] = (uint8)i;
+}
+
+// Startup as in main.c, then a level's worth of permanent data, 600 ordinary frames and one
+// frame that decodes a large asset into the transient arena
+static void bench_arena_run(BenchArenaKind kind) {
+    usize base_rss = bench_resident_bytes();
+    long base_faults = bench_minor_faults();
+
+    uint64 start = current_time_nanos();
+    BenchArena permanent = bench_arena_create(kind, MB(64), true);
+    BenchArena transient = bench_arena_create(kind, MB(128), false);
+    uint64 startup_nanos = current_time_nanos() - start;
+    usize startup_rss = bench_resident_bytes() - base_rss;
+
+    start = current_time_nanos();
+    bench_touch(bench_arena_alloc(&permanent, MB(8)), MB(8));
+    for (int frame = 0; frame < 600; frame++) {
+        bench_touch(bench_arena_alloc(&transient, KB(256)), KB(256));
+        bench_arena_reset(&transient);
+    }
+    uint64 steady_nanos = current_time_nanos() - start;
+    long steady_faults = bench_minor_faults() - base_faults;
+    usize steady_rss = bench_resident_bytes() - base_rss;
+
+    bench_touch(bench_arena_alloc(&transient, MB(96)), MB(96));
+    usize spike_rss = bench_resident_bytes() - base_rss;
+    bench_arena_reset(&transient);
+    usize after_rss = bench_resident_bytes() - base_rss;
+    long total_faults = bench_minor_faults() - base_faults;
+
+    printf("%-17s %9.1f us %9.2f ms %8ld %8ld %9.1f %9.1f %9.1f %9.1f\n",
+           bench_arena_names[kind], startup_nanos / 1000.0, steady_nanos / 1e6,
+           steady_faults, total_faults, startup_rss / 1048576.0, steady_rss / 1048576.0,
+           spike_rss / 1048576.0, after_rss / 1048576.0);
+
+    bench_arena_cleanup(&transient);
+    bench_arena_cleanup(&permanent);
+}
+
+int main(void) {
+    printf("Arena layout: 64 MB permanent + 128 MB transient, 8 MB permanent use, 600 x 256 KB frames, one 96 MB frame\n");
+    printf("%-17s %12s %12s %8s %8s %9s %9s %9s %9s\n", "arena", "startup", "frames",
+           "faults", "faults+", "rss0 MB", "rss MB", "spike MB", "reset MB");
+
+    for (int kind = BENCH_ARENA_MALLOC; kind <= BENCH_ARENA_DECOMMIT; kind++) {
+        fflush(stdout);
+        pid_t child = fork();
+        if (child == 0) {
+            bench_arena_run((BenchArenaKind)kind);
+            fflush(stdout);
+            _exit(0);
+        }
+        waitpid(child, nullptr, 0);
+    }
+    return 0;
+}
+#else
+int main(void) {
+    printf("bench_arena: RSS and page fault counters are only read on POSIX systems\n");
+    return 0;
+}
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file bench_audio_batch.c
+ * @brief Loading 2, 50 and 500 distinct static sounds with create_audio_sources_static_batch
+ * against one create_audio_source_static_memory call per sound.
+ *
+ * The sounds are copies of Randomize.ogg and Explosion.ogg with a number stamped into their
+ * Vorbis vendor string, so the sample cache shares nothing. A state holds MAX_AUDIO_SOURCES
+ * sources, so both sides load in chunks of that size, each into a fresh AudioState.
+ * Usage: bench_audio_batch, from the repository root. Run through `make bench RELEASE=1`.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+#include "utils.h"
+
+constexpr int BENCH_RUNS = 3;
+constexpr usize BENCH_MAX_SOUNDS = 500;
+
+typedef struct {
+    AudioLoadRequest requests[BENCH_MAX_SOUNDS];
+} BenchBatchLibrary;
+
+static bool bench_batch_library(Arena* arena, BenchBatchLibrary* library) {
+    const char* files[] = {"assets/sounds/Randomize.ogg", "assets/sounds/Explosion.ogg"};
+    const uint8 vendor[] = {0x03, 'v', 'o', 'r', 'b', 'i', 's', 11, 0, 0, 0};
+
+    for (usize f = 0; f < ARRAY_LEN(files); f++) {
+        usize size = 0;
+        uint8* original = audio_read_file(arena, files[f], &size);
+        if (!original) {
+            fprintf(stderr, "Error: Could not read %s, run from the repository root\n", files[f]);
+            return false;
+        }
+
+        // The comment header's vendor string is 11 bytes in both assets
+        usize stamp = 0;
+        for (usize i = 0; i + sizeof(vendor) <= size && !stamp; i++) {
+            if (memcmp(original + i, vendor, sizeof(vendor)) == 0) stamp = i + sizeof(vendor);
+        }
+        if (!stamp) {
+            fprintf(stderr, "Error: %s has no 11-byte vendor string\n", files[f]);
+            return false;
+        }
+
+        for (usize s = f; s < BENCH_MAX_SOUNDS; s += ARRAY_LEN(files)) {
+            uint8* data = arena_alloc(arena, size);
+            memcpy(data, original, size);
+            char number[12];
+            snprintf(number, sizeof(number), "Bench%06zu", s);
+            memcpy(data + stamp, number, 11);
+            library->requests[s] = (AudioLoadRequest){ .data = data, .data_size = size };
+        }
+    }
+    return true;
+}
+
+// Best time of BENCH_RUNS loads of the first `count` sounds, in milliseconds
+static real64 bench_batch_run(Arena* arena, Arena* transient, BenchBatchLibrary* library, usize count, bool batched) {
+    real64 best_ms = 1e30;
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        usize loaded = 0;
+        uint64 elapsed = 0;
+
+        for (usize first = 0; first < count; first += MAX_AUDIO_SOURCES) {
+            usize chunk = MIN(count - first, (usize)MAX_AUDIO_SOURCES);
+            ArenaTemp temp = arena_temp_begin(arena);
+            AudioState* state = create_audio_state(arena);
+
+            uint64 start = current_time_nanos();
+            if (batched) {
+                loaded += create_audio_sources_static_batch(
+                    arena, transient, state, library->requests + first, chunk, nullptr, nullptr);
+            } else {
+                for (usize i = first; i < first + chunk; i++) {
+                    AudioLoadRequest* request = &library->requests[i];
+                    AudioSourceHandle handle = create_audio_source_static_memory(
+                        arena, transient, state, request->data, request->data_size, false, AUDIO_DECODE_RANGES_SERIAL);
+                    loaded += !slot_handle_is_null(handle);
+                }
+            }
+            elapsed += current_time_nanos() - start;
+
+            audio_state_cleanup(state);
+            arena_temp_end(temp);
+        }
+
+        if (loaded != count) {
+            fprintf(stderr, "Error: %s loaded %zu of %zu sounds\n", batched ? "batch" : "serial", loaded, count);
+            exit(1);
+        }
+        best_ms = MIN(best_ms, (real64)elapsed / 1e6);
+    }
+    return best_ms;
+}
+
+int main(void) {
+    Arena arena = create_arena(GB(4));
+    Arena transient = create_arena(GB(1));
+    static BenchBatchLibrary library;
+    if (!bench_batch_library(&arena, &library)) return 1;
+
+    printf("Static loads from memory, best of %d, %d hardware threads\n", BENCH_RUNS, thread_hardware_concurrency());
+    printf("%8s %12s %12s %9s\n", "sounds", "serial ms", "batch ms", "speedup");
+
+    usize counts[] = {2, 50, BENCH_MAX_SOUNDS};
+    for (usize i = 0; i < ARRAY_LEN(counts); i++) {
+        real64 serial_ms = bench_batch_run(&arena, &transient, &library, counts[i], false);
+        real64 batch_ms = bench_batch_run(&arena, &transient, &library, counts[i], true);
+        printf("%8zu %12.1f %12.1f %8.2fx\n", counts[i], serial_ms, batch_ms, serial_ms / batch_ms);
+    }
+
+    arena_cleanup(&transient);
+    arena_cleanup(&arena);
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file bench_audio_cooked.c
+ * @brief Loading a sound from its cooked bytes (create_audio_source_static_cooked) against
+ * decoding its OGG (create_audio_source_static_memory), both already in memory as main.c
+ * has them with #embed.
+ *
+ * The cooked bytes are written by audio_cooked_write, as `make cook` does, to
+ * build/bench_audio_cooked.pcm. Every load uses a fresh AudioState, so the sample cache
+ * never answers. Usage: bench_audio_cooked, from the repository root. Run through
+ * `make bench RELEASE=1`.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+#include "utils.h"
+
+constexpr int BENCH_RUNS = 5;
+
+typedef enum {
+    BENCH_LOAD_OGG,
+    BENCH_LOAD_COOKED,
+} BenchLoadKind;
+
+// Best time of BENCH_RUNS loads in milliseconds, each into a fresh state
+static real64 bench_load_run(Arena* arena, Arena* transient, BenchLoadKind kind, const uint8* data, usize size) {
+    real64 best_ms = 1e30;
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        ArenaTemp temp = arena_temp_begin(arena);
+        AudioState* state = create_audio_state(arena);
+
+        uint64 start = current_time_nanos();
+        AudioSourceHandle handle = kind == BENCH_LOAD_OGG
+            ? create_audio_source_static_memory(arena, transient, state, data, size, false, AUDIO_DECODE_RANGES_SERIAL)
+            : create_audio_source_static_cooked(state, data, size, false);
+        real64 ms = (real64)(current_time_nanos() - start) / 1e6;
+
+        if (slot_handle_is_null(handle)) {
+            fprintf(stderr, "Error: %s load failed\n", kind == BENCH_LOAD_OGG ? "OGG" : "cooked");
+            exit(1);
+        }
+        audio_state_cleanup(state);
+        arena_temp_end(temp);
+        best_ms = MIN(best_ms, ms);
+    }
+    return best_ms;
+}
+
+int main(void) {
+    Arena arena = create_arena(GB(1));
+    Arena transient = create_arena(GB(1));
+    const char* files[] = {"assets/sounds/Explosion.ogg", "assets/sounds/Background.ogg"};
+    const char* cooked_path = "build/bench_audio_cooked.pcm";
+
+    printf("Static load from memory, best of %d\n", BENCH_RUNS);
+    printf("%-30s %10s %10s %10s %10s %9s\n", "asset", "ogg KB", "cooked KB", "ogg ms", "cooked us", "speedup");
+
+    for (usize f = 0; f < ARRAY_LEN(files); f++) {
+        usize ogg_size = 0;
+        uint8* ogg = audio_read_file(&arena, files[f], &ogg_size);
+        if (!ogg) {
+            fprintf(stderr, "Error: Could not read %s, run from the repository root\n", files[f]);
+            return 1;
+        }
+
+        // Cooked from the same decode the OGG path produces
+        ArenaTemp temp = arena_temp_begin(&arena);
+        AudioState* state = create_audio_state(&arena);
+        AudioSourceHandle handle = create_audio_source_static_memory(
+            &arena, &transient, state, ogg, ogg_size, false, AUDIO_DECODE_RANGES_SERIAL);
+        const AudioSource* source = audio_source_get(state, handle);
+        bool cooked_written = source && audio_cooked_write(
+            cooked_path, audio_sample_cache_key(ogg, ogg_size, AUDIO_SAMPLES_PCM16),
+            source->static_data.samples, source->static_data.frame_count);
+        audio_state_cleanup(state);
+        arena_temp_end(temp);
+        if (!cooked_written) {
+            fprintf(stderr, "Error: Could not cook %s into %s, run from the repository root\n", files[f], cooked_path);
+            return 1;
+        }
+
+        usize cooked_size = 0;
+        uint8* cooked = audio_read_file(&arena, cooked_path, &cooked_size);
+        remove(cooked_path);
+        if (!cooked) {
+            fprintf(stderr, "Error: Could not read back %s\n", cooked_path);
+            return 1;
+        }
+
+        real64 ogg_ms = bench_load_run(&arena, &transient, BENCH_LOAD_OGG, ogg, ogg_size);
+        real64 cooked_ms = bench_load_run(&arena, &transient, BENCH_LOAD_COOKED, cooked, cooked_size);
+        printf("%-30s %10.1f %10.1f %10.3f %10.2f %8.0fx\n", files[f], ogg_size / 1024.0, cooked_size / 1024.0,
+               ogg_ms, cooked_ms * 1000.0, ogg_ms / cooked_ms);
+    }
+
+    arena_cleanup(&transient);
+    arena_cleanup(&arena);
+    return 0;
+}
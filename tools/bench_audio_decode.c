@@ -0,0 +1,99 @@
+/**
+ * @file bench_audio_decode.c
+ * @brief Static decode of Background.ogg split into 1, 2, 4 and 8 parallel ranges.
+ *
+ * Reports the measured wall time through job_run and, for machines with fewer cores than
+ * ranges, the projected time with one core per range: the decoder opens (serial, on the
+ * calling thread) plus the slowest range. Usage: bench_audio_decode, from the repository
+ * root. Run through `make bench RELEASE=1`.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+#include "utils.h"
+
+constexpr int BENCH_RUNS = 3;
+
+typedef struct {
+    real64 wall_ms;             // audio_decode_vorbis_ranges on this machine
+    real64 open_ms;             // Opening the extra decoders
+    real64 slowest_range_ms;    // Each range decoded alone, the slowest one
+} BenchDecodeTimes;
+
+static BenchDecodeTimes bench_decode_run(Arena* arena, const AudioLoadRequest* request, int16* samples,
+                                         usize capacity, usize range_count) {
+    BenchDecodeTimes best = { .wall_ms = 1e30, .open_ms = 1e30, .slowest_range_ms = 1e30 };
+
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        ArenaTemp temp = arena_temp_begin(arena);
+        stb_vorbis* vorbis = audio_load_request_open(request);
+        uint64 start = current_time_nanos();
+        usize frames = range_count > 1
+            ? audio_decode_vorbis_ranges(arena, request, vorbis, samples, capacity, range_count)
+            : audio_decode_vorbis_range(vorbis, arena, samples, 0, capacity);
+        real64 wall_ms = (real64)(current_time_nanos() - start) / 1e6;
+        stb_vorbis_close(vorbis);
+        arena_temp_end(temp);
+        if (frames != capacity) {
+            fprintf(stderr, "Error: %zu ranges decoded %zu of %zu frames\n", range_count, frames, capacity);
+            exit(1);
+        }
+
+        // The same ranges one at a time, as audio_decode_range_job splits them. The first
+        // decoder is the caller's, only the others are opened per load.
+        stb_vorbis* decoders[8];
+        decoders[0] = audio_load_request_open(request);
+        start = current_time_nanos();
+        for (usize r = 1; r < range_count; r++) decoders[r] = audio_load_request_open(request);
+        real64 open_ms = (real64)(current_time_nanos() - start) / 1e6;
+
+        real64 slowest_ms = 0.0;
+        for (usize r = 0; r < range_count; r++) {
+            usize first = capacity * r / range_count;
+            usize count = capacity * (r + 1) / range_count - first;
+            temp = arena_temp_begin(arena);
+            start = current_time_nanos();
+            audio_decode_vorbis_range(decoders[r], arena, samples, first, count);
+            slowest_ms = MAX(slowest_ms, (real64)(current_time_nanos() - start) / 1e6);
+            arena_temp_end(temp);
+            stb_vorbis_close(decoders[r]);
+        }
+
+        best.wall_ms = MIN(best.wall_ms, wall_ms);
+        best.open_ms = MIN(best.open_ms, open_ms);
+        best.slowest_range_ms = MIN(best.slowest_range_ms, slowest_ms);
+    }
+    return best;
+}
+
+int main(void) {
+    Arena arena = create_arena(GB(1));
+    AudioLoadRequest request = { .filename = "assets/sounds/Background.ogg" };
+    request.data = audio_read_file(&arena, request.filename, &request.data_size);
+    if (!request.data) {
+        fprintf(stderr, "Error: Could not read %s, run from the repository root\n", request.filename);
+        return 1;
+    }
+
+    stb_vorbis* vorbis = audio_load_request_open(&request);
+    usize capacity = audio_decoded_capacity(vorbis);
+    stb_vorbis_close(vorbis);
+    int16* samples = (int16*)arena_alloc(&arena, capacity * AUDIO_CHANNELS * sizeof(int16));
+
+    printf("%s: %zu frames (%.1f s), best of %d, %d hardware threads\n", request.filename, capacity,
+           (real64)capacity / AUDIO_SAMPLE_RATE, BENCH_RUNS, thread_hardware_concurrency());
+    printf("%-7s %10s %9s %14s %9s\n", "ranges", "wall ms", "speedup", "projected ms", "speedup");
+
+    usize range_counts[] = {1, 2, 4, 8};
+    real64 serial_ms = 0.0;
+    for (usize i = 0; i < ARRAY_LEN(range_counts); i++) {
+        BenchDecodeTimes times = bench_decode_run(&arena, &request, samples, capacity, range_counts[i]);
+        if (i == 0) serial_ms = times.wall_ms;
+        real64 projected_ms = times.open_ms + times.slowest_range_ms;
+        printf("%-7zu %10.1f %8.2fx %14.1f %8.2fx\n", range_counts[i], times.wall_ms, serial_ms / times.wall_ms,
+               projected_ms, serial_ms / projected_ms);
+    }
+
+    arena_cleanup(&arena);
+    return 0;
+}
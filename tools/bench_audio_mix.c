@@ -0,0 +1,165 @@
+/**
+ * @file bench_audio_mix.c
+ * @brief Mixed frames per second for 1, 16 and 256 concurrent sources: the original
+ * per-sample float mixer, the scalar reference kernels and the SIMD kernels. Then the cost of
+ * 1, 16 and 256 voices through audio_state_update for PCM16 and IMA-ADPCM sources.
+ *
+ * A frame is one stereo output frame with every source mixed in and clipped. Build with
+ * -mavx2 to measure the AVX2 path. Usage: bench_audio_mix. Run through `make bench RELEASE=1`.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+#include "utils.h"
+
+constexpr usize BENCH_BLOCK_SAMPLES = 1600;     // One 60 Hz block of 48 kHz stereo
+constexpr usize BENCH_SOURCE_SAMPLES = 1 << 18;
+
+typedef enum {
+    BENCH_MIX_FLOAT,
+    BENCH_MIX_SCALAR,
+    BENCH_MIX_SIMD,
+} BenchMixKind;
+
+// The mixer before audio_mix.h: int -> float -> int per sample and a clamp per source
+static void bench_mix_float(int16* out, const int16* src, usize samples, real32 volume) {
+    for (usize i = 0; i < samples; i++) {
+        int mixed = (int)out[i] + (int)(src[i] * volume);
+        out[i] = (int16)CLAMP(mixed, -32768, 32767);
+    }
+}
+
+static real64 bench_mix_run(BenchMixKind kind, const int16* source, usize source_count, usize blocks) {
+    static int32 bus[BENCH_BLOCK_SAMPLES];
+    static int16 out[BENCH_BLOCK_SAMPLES];
+    volatile int16 sink = 0;
+
+    uint64 start = current_time_nanos();
+    for (usize block = 0; block < blocks; block++) {
+        if (kind == BENCH_MIX_FLOAT) {
+            memset(out, 0, sizeof(out));
+        } else {
+            memset(bus, 0, sizeof(bus));
+        }
+
+        for (usize s = 0; s < source_count; s++) {
+            // Every source reads a different part of the buffer, as voices would
+            usize position = ((block + s * 97) * BENCH_BLOCK_SAMPLES) % (BENCH_SOURCE_SAMPLES - BENCH_BLOCK_SAMPLES);
+            const int16* src = source + position;
+            real32 volume = 0.25f + (real32)(s % 7) * 0.1f;
+
+            switch (kind) {
+                case BENCH_MIX_FLOAT:
+                    bench_mix_float(out, src, BENCH_BLOCK_SAMPLES, volume);
+                    break;
+                case BENCH_MIX_SCALAR:
+                    mix_s16_scalar(bus, src, BENCH_BLOCK_SAMPLES, audio_gain_q15(volume));
+                    break;
+                case BENCH_MIX_SIMD:
+                    mix_s16(bus, src, BENCH_BLOCK_SAMPLES, audio_gain_q15(volume));
+                    break;
+            }
+        }
+
+        if (kind == BENCH_MIX_SCALAR) {
+            mix_bus_to_s16_scalar(out, bus, BENCH_BLOCK_SAMPLES, 0.8f);
+        } else if (kind == BENCH_MIX_SIMD) {
+            mix_bus_to_s16(out, bus, BENCH_BLOCK_SAMPLES, 0.8f);
+        }
+        sink = out[block % BENCH_BLOCK_SAMPLES];
+    }
+    (void)sink;
+
+    real64 seconds = (real64)(current_time_nanos() - start) / NANOS_PER_SEC;
+    return (real64)(blocks * BENCH_BLOCK_SAMPLES / 2) / seconds;
+}
+
+// Nanoseconds per voice per block, every voice of the looping source at its own playhead
+static real64 bench_voice_run(Arena* arena, const AudioSource* source, usize voice_count, usize blocks) {
+    ArenaTemp temp = arena_temp_begin(arena);
+    AudioState* state = create_audio_state(arena);
+    AudioSourceHandle handle = source->static_data.format == AUDIO_SAMPLES_PCM16
+        ? audio_source_insert_static(state, source->static_data.samples, source->static_data.frame_count, true)
+        : audio_source_insert_adpcm(state, source->static_data.adpcm_blocks, source->static_data.frame_count, true);
+
+    for (usize v = 0; v < voice_count; v++) {
+        AudioVoice* voice = audio_voice_get(state, audio_voice_play(state, handle));
+        voice->position = (v * 97 * (AUDIO_CAPACITY / AUDIO_CHANNELS)) % source->static_data.frame_count;
+    }
+    audio_state_update(state);
+
+    uint64 start = current_time_nanos();
+    for (usize block = 0; block < blocks; block++) audio_state_update(state);
+    real64 ns = (real64)(current_time_nanos() - start) / (real64)(blocks * voice_count);
+
+    audio_state_cleanup(state);
+    arena_temp_end(temp);
+    return ns;
+}
+
+int main(void) {
+    Arena arena = create_arena(MB(64));
+    int16* source = (int16*)arena_alloc(&arena, BENCH_SOURCE_SAMPLES * sizeof(int16));
+    uint32 seed = 0x2545F491u;
+    for (usize i = 0; i < BENCH_SOURCE_SAMPLES; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        source[i] = (int16)(seed >> 16);
+    }
+
+#if AUDIO_MIX_AVX2
+    const char* simd = "AVX2";
+#elif AUDIO_MIX_SSE2
+    const char* simd = "SSE2";
+#else
+    const char* simd = "scalar";
+#endif
+    printf("Mixed frames per second (millions), %s kernels\n", simd);
+    printf("%8s %12s %12s %12s %9s\n", "sources", "float", "scalar q15", simd, "speedup");
+
+    usize source_counts[] = {1, 16, 256};
+    for (usize i = 0; i < ARRAY_LEN(source_counts); i++) {
+        usize count = source_counts[i];
+        // About the same amount of work per row
+        usize blocks = MAX((usize)20000 / count, (usize)50);
+        bench_mix_run(BENCH_MIX_SIMD, source, count, blocks / 10 + 1);
+
+        real64 float_fps = bench_mix_run(BENCH_MIX_FLOAT, source, count, blocks);
+        real64 scalar_fps = bench_mix_run(BENCH_MIX_SCALAR, source, count, blocks);
+        real64 simd_fps = bench_mix_run(BENCH_MIX_SIMD, source, count, blocks);
+        printf("%8zu %12.1f %12.1f %12.1f %8.1fx\n",
+               count, float_fps / 1e6, scalar_fps / 1e6, simd_fps / 1e6, simd_fps / float_fps);
+    }
+
+    // The same samples kept as PCM16 and as ADPCM blocks
+    usize frame_count = BENCH_SOURCE_SAMPLES / AUDIO_CHANNELS;
+    usize adpcm_bytes = audio_adpcm_size(frame_count, AUDIO_CHANNELS);
+    uint8* adpcm_blocks = (uint8*)arena_alloc(&arena, adpcm_bytes);
+    audio_adpcm_encode(adpcm_blocks, source, frame_count, AUDIO_CHANNELS);
+    AudioSource pcm_source = {
+        .static_data = { .format = AUDIO_SAMPLES_PCM16, .samples = source, .frame_count = frame_count },
+    };
+    AudioSource adpcm_source = {
+        .static_data = { .format = AUDIO_SAMPLES_ADPCM, .adpcm_blocks = adpcm_blocks, .frame_count = frame_count },
+    };
+
+    printf("\nVoices through audio_state_update, %zu frames per source\n", frame_count);
+    printf("%-7s %12s %12s\n", "format", "bytes/source", "bytes/frame");
+    printf("%-7s %12zu %12.2f\n", "PCM16", BENCH_SOURCE_SAMPLES * sizeof(int16),
+           (real64)(BENCH_SOURCE_SAMPLES * sizeof(int16)) / frame_count);
+    printf("%-7s %12zu %12.2f\n", "ADPCM", adpcm_bytes, (real64)adpcm_bytes / frame_count);
+    printf("%8s %14s %14s %9s\n", "voices", "PCM16 ns", "ADPCM ns", "ratio");
+
+    usize voice_counts[] = {1, 16, 256};
+    for (usize i = 0; i < ARRAY_LEN(voice_counts); i++) {
+        usize count = voice_counts[i];
+        usize blocks = MAX((usize)20000 / count, (usize)50);
+        real64 pcm_ns = bench_voice_run(&arena, &pcm_source, count, blocks);
+        real64 adpcm_ns = bench_voice_run(&arena, &adpcm_source, count, blocks);
+        printf("%8zu %14.0f %14.0f %8.1fx\n", count, pcm_ns, adpcm_ns, adpcm_ns / pcm_ns);
+    }
+
+    arena_cleanup(&arena);
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file bench_hashmap.c
+ * @brief Name lookups through HashMap against a linear search, at 16, 1k and 100k entries.
+ *
+ * Usage: bench_hashmap. Run through `make bench RELEASE=1`.
+ */
+#include "def.h"
+#include "arena.h"
+#include "hashmap.h"
+#include "utils.h"
+
+typedef struct {
+    const char* name;
+    usize len;
+    uint64 value;
+} BenchNamedValue;
+
+static uint32 bench_random(uint32* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static bool bench_linear_find(BenchNamedValue* values, usize count, const char* name, usize len, uint64* value) {
+    for (usize i = 0; i < count; i++) {
+        if (values[i].len == len && memcmp(values[i].name, name, len) == 0) {
+            *value = values[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void bench_hashmap_run(Arena* arena, usize count) {
+    ArenaTemp temp = arena_temp_begin(arena);
+
+    // Asset-like names that share a long prefix, the worst case for memcmp
+    BenchNamedValue* values = (BenchNamedValue*)arena_alloc(arena, count * sizeof(BenchNamedValue));
+    HashKey* keys = (HashKey*)arena_alloc(arena, count * sizeof(HashKey));
+    for (usize i = 0; i < count; i++) {
+        char* name = (char*)arena_alloc(arena, 48);
+        int len = snprintf(name, 48, "assets/sounds/effect_%06zu.ogg", i * 7919 % 1000003);
+        values[i] = (BenchNamedValue){ .name = name, .len = (usize)len, .value = i };
+        keys[i] = hash_key_string(name, (usize)len);
+    }
+
+    uint64 start = current_time_nanos();
+    HashMap map = create_hash_map(arena, 16);
+    for (usize i = 0; i < count; i++) {
+        hash_map_put(&map, keys[i], values[i].value);
+    }
+    real64 build_ns = (real64)(current_time_nanos() - start) / count;
+
+    // Linear search is quadratic at 100k entries, so it gets fewer lookups
+    usize lookups = count >= 100000 ? 2000 : 1000000;
+    usize* order = (usize*)arena_alloc(arena, lookups * sizeof(usize));
+    uint32 seed = 0x12345678u;
+    for (usize i = 0; i < lookups; i++) order[i] = bench_random(&seed) % count;
+
+    uint64 linear_sum = 0, precomputed_sum = 0, hashed_sum = 0, value = 0;
+
+    start = current_time_nanos();
+    for (usize i = 0; i < lookups; i++) {
+        BenchNamedValue* wanted = &values[order[i]];
+        if (bench_linear_find(values, count, wanted->name, wanted->len, &value)) linear_sum += value;
+    }
+    real64 linear_ns = (real64)(current_time_nanos() - start) / lookups;
+
+    start = current_time_nanos();
+    for (usize i = 0; i < lookups; i++) {
+        if (hash_map_get(&map, keys[order[i]], &value)) precomputed_sum += value;
+    }
+    real64 precomputed_ns = (real64)(current_time_nanos() - start) / lookups;
+
+    start = current_time_nanos();
+    for (usize i = 0; i < lookups; i++) {
+        BenchNamedValue* wanted = &values[order[i]];
+        if (hash_map_get(&map, hash_key_string(wanted->name, wanted->len), &value)) hashed_sum += value;
+    }
+    real64 hashed_ns = (real64)(current_time_nanos() - start) / lookups;
+
+    if (linear_sum != precomputed_sum || linear_sum != hashed_sum) {
+        fprintf(stderr, "Error: lookups disagree at %zu entries\n", count);
+        exit(1);
+    }
+
+    printf("%8zu %10.1f %12.1f %14.1f %14.1f %9.0fx\n",
+           count, build_ns, linear_ns, precomputed_ns, hashed_ns, linear_ns / precomputed_ns);
+    arena_temp_end(temp);
+}
+
+int main(void) {
+    Arena arena = create_arena(GB(1));
+    printf("ns per operation, hit lookups on random keys\n");
+    printf("%8s %10s %12s %14s %14s %10s\n", "entries", "insert", "linear", "map (prehash)", "map (hash)", "speedup");
+
+    usize counts[] = {16, 1024, 100000};
+    for (usize i = 0; i < ARRAY_LEN(counts); i++) {
+        bench_hashmap_run(&arena, counts[i]);
+    }
+
+    arena_cleanup(&arena);
+    return 0;
+}
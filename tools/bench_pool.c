@@ -0,0 +1,124 @@
+/**
+ * @file bench_pool.c
+ * @brief Pool allocator against malloc/free on churn-heavy patterns: particles dying in
+ * random order, FIFO bursts and LIFO scratch objects.
+ *
+ * Usage: bench_pool. Run through `make bench RELEASE=1`.
+ */
+#include "def.h"
+#include "arena.h"
+#include "pool.h"
+#include "utils.h"
+
+constexpr usize BENCH_LIVE_COUNT = 4096;
+constexpr usize BENCH_OPERATIONS = 4 * 1024 * 1024;
+
+typedef struct {
+    Pool pool;
+    usize size;
+    bool use_malloc;
+} BenchAllocator;
+
+static inline void* bench_alloc(BenchAllocator* allocator) {
+    void* block = allocator->use_malloc ? malloc(allocator->size) : pool_alloc(&allocator->pool);
+    // Touch the block, as a caller initializing it would
+    *(volatile uint8*)block = 1;
+    return block;
+}
+
+static inline void bench_free(BenchAllocator* allocator, void* block) {
+    if (allocator->use_malloc) {
+        free(block);
+    } else {
+        pool_free(&allocator->pool, block);
+    }
+}
+
+static uint32 bench_random(uint32* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// A fixed live set where a random element dies and is replaced every step (particles, voices)
+static uint64 bench_random_churn(BenchAllocator* allocator, void** live) {
+    uint32 seed = 0x9E3779B9u;
+    for (usize i = 0; i < BENCH_LIVE_COUNT; i++) live[i] = bench_alloc(allocator);
+
+    uint64 start = current_time_nanos();
+    for (usize i = 0; i < BENCH_OPERATIONS; i++) {
+        usize victim = bench_random(&seed) % BENCH_LIVE_COUNT;
+        bench_free(allocator, live[victim]);
+        live[victim] = bench_alloc(allocator);
+    }
+    uint64 elapsed = current_time_nanos() - start;
+
+    for (usize i = 0; i < BENCH_LIVE_COUNT; i++) bench_free(allocator, live[i]);
+    return elapsed;
+}
+
+// 64 objects spawn per frame and live for 60 frames, freed oldest first (effects, bullets)
+static uint64 bench_fifo_burst(BenchAllocator* allocator, void** live) {
+    usize per_frame = 64, lifetime = 60;
+    usize window = per_frame * lifetime;
+    assert(window <= BENCH_LIVE_COUNT);
+
+    uint64 start = current_time_nanos();
+    for (usize i = 0; i < BENCH_OPERATIONS; i++) {
+        usize slot = i % window;
+        if (i >= window) bench_free(allocator, live[slot]);
+        live[slot] = bench_alloc(allocator);
+    }
+    uint64 elapsed = current_time_nanos() - start;
+
+    for (usize i = 0; i < MIN(window, BENCH_OPERATIONS); i++) bench_free(allocator, live[i]);
+    return elapsed;
+}
+
+// Short-lived objects freed in reverse order within a frame (scratch nodes, commands)
+static uint64 bench_lifo(BenchAllocator* allocator, void** live) {
+    usize batch = 256;
+
+    uint64 start = current_time_nanos();
+    for (usize i = 0; i < BENCH_OPERATIONS; i += batch) {
+        for (usize j = 0; j < batch; j++) live[j] = bench_alloc(allocator);
+        for (usize j = batch; j-- > 0;) bench_free(allocator, live[j]);
+    }
+    return current_time_nanos() - start;
+}
+
+int main(void) {
+    usize sizes[] = {64, 200, 1024};
+    const char* pattern_names[] = {"random churn", "fifo burst", "lifo"};
+    uint64 (*patterns[])(BenchAllocator*, void**) = {bench_random_churn, bench_fifo_burst, bench_lifo};
+
+    Arena arena = create_arena(GB(1));
+    void** live = (void**)arena_alloc(&arena, BENCH_LIVE_COUNT * sizeof(void*));
+
+    printf("%zu alloc/free pairs per run, %zu live objects\n", BENCH_OPERATIONS, BENCH_LIVE_COUNT);
+    printf("%-13s %6s %12s %12s %8s\n", "pattern", "bytes", "malloc ns", "pool ns", "speedup");
+
+    for (usize p = 0; p < ARRAY_LEN(patterns); p++) {
+        for (usize s = 0; s < ARRAY_LEN(sizes); s++) {
+            ArenaTemp temp = arena_temp_begin(&arena);
+            BenchAllocator pool = {
+                .pool = create_pool(&arena, sizes[s], BENCH_LIVE_COUNT, true),
+                .size = sizes[s],
+            };
+            BenchAllocator heap = { .size = sizes[s], .use_malloc = true };
+
+            // Warm both up once so neither pays for first-touch page faults
+            patterns[p](&heap, live);
+            patterns[p](&pool, live);
+            real64 heap_ns = (real64)patterns[p](&heap, live) / BENCH_OPERATIONS;
+            real64 pool_ns = (real64)patterns[p](&pool, live) / BENCH_OPERATIONS;
+
+            printf("%-13s %6zu %12.2f %12.2f %7.1fx\n", pattern_names[p], sizes[s], heap_ns, pool_ns, heap_ns / pool_ns);
+            arena_temp_end(temp);
+        }
+    }
+
+    arena_cleanup(&arena);
+    return 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file bench_resampler.c
+ * @brief Streaming resampler throughput: output frames per second for linear and sinc at
+ * the rates the streaming path converts, pushed in decoder-sized chunks.
+ *
+ * Build with -mavx2 to measure the AVX2 dot product. Usage: bench_resampler.
+ * Run through `make bench RELEASE=1`.
+ */
+#include "def.h"
+#include "arena.h"
+#include "resampler.h"
+#include "utils.h"
+
+constexpr usize BENCH_CHUNK_FRAMES = 4096;         // As AUDIO_DECODE_CHUNK_FRAMES
+constexpr usize BENCH_INPUT_SECONDS = 60;
+
+static real64 bench_resampler_run(Arena* arena, ResampleQuality quality, int input_rate, const int16* input) {
+    ArenaTemp temp = arena_temp_begin(arena);
+    usize input_frames = BENCH_INPUT_SECONDS * (usize)input_rate;
+    usize max_output = BENCH_CHUNK_FRAMES * 48000 / (usize)input_rate + 64;
+    int16* output = (int16*)arena_alloc(arena, max_output * 2 * sizeof(int16));
+
+    Resampler resampler;
+    resampler_init(&resampler, arena, 2, input_rate, 48000, quality, BENCH_CHUNK_FRAMES);
+
+    volatile int16 sink = 0;
+    usize consumed = 0, produced = 0;
+    uint64 start = current_time_nanos();
+    while (consumed < input_frames) {
+        consumed += resampler_push(&resampler, input + consumed * 2, MIN(BENCH_CHUNK_FRAMES, input_frames - consumed));
+        usize frames = resampler_pull(&resampler, output, max_output);
+        if (frames > 0) sink += output[(frames - 1) * 2];
+        produced += frames;
+    }
+    real64 seconds = (real64)(current_time_nanos() - start) / 1e9;
+    (void)sink;
+
+    arena_temp_end(temp);
+    return (real64)produced / seconds;
+}
+
+int main(void) {
+    Arena arena = create_arena(GB(1));
+    usize max_input = BENCH_INPUT_SECONDS * 96000 * 2;
+    int16* input = (int16*)arena_alloc(&arena, max_input * sizeof(int16));
+    uint32 seed = 0x2545F491u;
+    for (usize i = 0; i < max_input; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        input[i] = (int16)(seed >> 16);
+    }
+
+#if AUDIO_MIX_AVX2
+    const char* simd = "AVX2";
+#elif AUDIO_MIX_SSE2
+    const char* simd = "SSE2";
+#else
+    const char* simd = "scalar";
+#endif
+    printf("Stereo, %zu s of input per run, %zu-frame chunks, %s dot product\n", BENCH_INPUT_SECONDS, BENCH_CHUNK_FRAMES, simd);
+    printf("%-8s %8s %14s %12s\n", "quality", "input", "Mframes/s", "x realtime");
+
+    int rates[] = {22050, 44100, 96000};
+    for (int quality = RESAMPLE_LINEAR; quality <= RESAMPLE_SINC; quality++) {
+        for (usize r = 0; r < ARRAY_LEN(rates); r++) {
+            // Once to fault in the buffers, then measured
+            bench_resampler_run(&arena, (ResampleQuality)quality, rates[r], input);
+            real64 frames_per_second = bench_resampler_run(&arena, (ResampleQuality)quality, rates[r], input);
+            printf("%-8s %8d %14.1f %11.0fx\n", quality == RESAMPLE_SINC ? "sinc" : "linear", rates[r],
+                   frames_per_second / 1e6, frames_per_second / 48000.0);
+        }
+    }
+
+    arena_cleanup(&arena);
+    return 0;
+}
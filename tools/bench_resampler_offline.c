@@ -0,0 +1,135 @@
+/**
+ * @file bench_resampler_offline.c
+ * @brief Offline linear resampling of a 3-minute 44.1 kHz stereo track to 48 kHz: the
+ * original real64 resample_audio against resample_linear_range, scalar, SIMD and split
+ * across job.h workers. Also checks the split result is bit-identical.
+ *
+ * Build with -mavx2 to measure the AVX2 path. Usage: bench_resampler_offline.
+ * Run through `make bench RELEASE=1`.
+ */
+#include "def.h"
+#include "arena.h"
+#include "job.h"
+#include "resampler.h"
+#include "utils.h"
+
+#include <string.h>
+
+constexpr usize BENCH_INPUT_FRAMES = 180 * 44100;
+constexpr usize BENCH_FRAMES_PER_JOB = 1 << 18;
+constexpr int BENCH_RUNS = 5;
+
+// resample_audio before resampler.h: a real64 position and real64 lerp per sample
+static void bench_resample_real64(const int16* input, usize input_frames, int channels, int input_rate,
+                                  int output_rate, int16* output, usize output_frames) {
+    real64 ratio = (real64)output_rate / (real64)input_rate;
+    for (usize i = 0; i < output_frames; i++) {
+        real64 source_index = (real64)i / ratio;
+        usize index1 = (usize)source_index;
+        usize index2 = index1 + 1;
+        if (index1 >= input_frames) index1 = input_frames - 1;
+        if (index2 >= input_frames) index2 = input_frames - 1;
+        real64 fraction = source_index - (real64)index1;
+
+        for (int ch = 0; ch < channels; ch++) {
+            int16 sample1 = input[index1 * channels + ch];
+            int16 sample2 = input[index2 * channels + ch];
+            real64 interpolated = (real64)sample1 + fraction * ((real64)sample2 - (real64)sample1);
+            output[i * channels + ch] = (int16)CLAMP(interpolated, -32768.0, 32767.0);
+        }
+    }
+}
+
+typedef struct {
+    const int16* input;
+    uint64 step;
+    int16* output;
+    usize output_frames;
+} BenchResampleJob;
+
+static void bench_resample_job(void* data, usize job_index) {
+    BenchResampleJob* job = (BenchResampleJob*)data;
+    usize first = job_index * BENCH_FRAMES_PER_JOB;
+    usize count = MIN(BENCH_FRAMES_PER_JOB, job->output_frames - first);
+    resample_linear_range(job->input, BENCH_INPUT_FRAMES, 2, job->step, job->output, first, count);
+}
+
+typedef enum {
+    BENCH_RESAMPLE_REAL64,
+    BENCH_RESAMPLE_SCALAR,
+    BENCH_RESAMPLE_SIMD,
+    BENCH_RESAMPLE_JOBS,
+} BenchResampleKind;
+
+static real64 bench_resample_run(BenchResampleKind kind, const int16* input, int16* output, usize output_frames) {
+    uint64 step = resample_step(44100, 48000);
+    real64 best = 1e30;
+
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        uint64 start = current_time_nanos();
+        switch (kind) {
+            case BENCH_RESAMPLE_REAL64:
+                bench_resample_real64(input, BENCH_INPUT_FRAMES, 2, 44100, 48000, output, output_frames);
+                break;
+            case BENCH_RESAMPLE_SCALAR:
+                resample_linear_range_scalar(input, BENCH_INPUT_FRAMES, 2, step, output, 0, output_frames);
+                break;
+            case BENCH_RESAMPLE_SIMD:
+                resample_linear_range(input, BENCH_INPUT_FRAMES, 2, step, output, 0, output_frames);
+                break;
+            case BENCH_RESAMPLE_JOBS: {
+                BenchResampleJob job = { .input = input, .step = step, .output = output, .output_frames = output_frames };
+                job_run(bench_resample_job, &job, (output_frames + BENCH_FRAMES_PER_JOB - 1) / BENCH_FRAMES_PER_JOB);
+                break;
+            }
+        }
+        best = MIN(best, (real64)(current_time_nanos() - start) / 1e6);
+    }
+    return best;
+}
+
+int main(void) {
+    Arena arena = create_arena(GB(1));
+    usize output_frames = resample_output_frames(BENCH_INPUT_FRAMES, 44100, 48000);
+    int16* input = (int16*)arena_alloc(&arena, BENCH_INPUT_FRAMES * 2 * sizeof(int16));
+    int16* output = (int16*)arena_alloc(&arena, output_frames * 2 * sizeof(int16));
+    int16* reference = (int16*)arena_alloc(&arena, output_frames * 2 * sizeof(int16));
+
+    uint32 seed = 0x2545F491u;
+    for (usize i = 0; i < BENCH_INPUT_FRAMES * 2; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        input[i] = (int16)(seed >> 16);
+    }
+
+#if AUDIO_MIX_AVX2
+    const char* simd = "AVX2";
+#elif AUDIO_MIX_SSE2
+    const char* simd = "SSE2";
+#else
+    const char* simd = "scalar";
+#endif
+    printf("3:00 of 44.1 kHz stereo -> %zu frames at 48 kHz, best of %d, warm output, %s, %d hardware threads\n",
+           output_frames, BENCH_RUNS, simd, thread_hardware_concurrency());
+    printf("%-22s %10s %9s\n", "resampler", "ms", "speedup");
+
+    const char* names[] = {"real64 (original)", "fixed point scalar", "fixed point SIMD", "fixed point SIMD jobs"};
+    real64 baseline = 0.0;
+    for (int kind = BENCH_RESAMPLE_REAL64; kind <= BENCH_RESAMPLE_JOBS; kind++) {
+        real64 ms = bench_resample_run((BenchResampleKind)kind, input, output, output_frames);
+        if (kind == BENCH_RESAMPLE_REAL64) baseline = ms;
+        printf("%-22s %10.2f %8.1fx\n", names[kind], ms, baseline / ms);
+
+        // Every fixed-point variant must produce the scalar reference's output exactly
+        if (kind == BENCH_RESAMPLE_SCALAR) {
+            memcpy(reference, output, output_frames * 2 * sizeof(int16));
+        } else if (kind > BENCH_RESAMPLE_SCALAR && memcmp(reference, output, output_frames * 2 * sizeof(int16)) != 0) {
+            fprintf(stderr, "Error: %s output differs from the scalar reference\n", names[kind]);
+            return 1;
+        }
+    }
+
+    arena_cleanup(&arena);
+    return 0;
+}
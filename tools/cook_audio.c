@@ -0,0 +1,58 @@
+/**
+ * @file cook_audio.c
+ * @brief Offline audio cooker: decodes an OGG to the mixer's format (AUDIO_SAMPLE_RATE,
+ * AUDIO_CHANNELS) and writes it as a cooked sound, see AudioCookedHeader.
+ *
+ * Usage: cook_audio <input.ogg> <output.pcm>
+ * Run through `make cook`, which re-cooks whenever the sounds or the target format change.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <input.ogg> <output.pcm>\n", argv[0]);
+        return 1;
+    }
+    const char* input_path = argv[1];
+    const char* output_path = argv[2];
+
+    // Reserves address space only, pages are committed as the file and samples are written
+    Arena arena = create_arena(GB(1));
+    usize data_size = 0;
+    uint8* data = audio_read_file(&arena, input_path, &data_size);
+    if (!data || data_size > INT_MAX) {
+        fprintf(stderr, "Error: Could not read '%s'\n", input_path);
+        arena_cleanup(&arena);
+        return 1;
+    }
+
+    AudioLoadRequest request = { .data = data, .data_size = data_size };
+    stb_vorbis* vorbis = audio_load_request_open(&request);
+    usize capacity_frames = vorbis ? audio_decoded_capacity(vorbis) : 0;
+    if (capacity_frames == 0) {
+        fprintf(stderr, "Error: Could not open '%s' or read its stream length\n", input_path);
+        if (vorbis) stb_vorbis_close(vorbis);
+        arena_cleanup(&arena);
+        return 1;
+    }
+
+    int16* samples = arena_alloc(&arena, capacity_frames * AUDIO_CHANNELS * sizeof(int16));
+    usize frame_count = samples ? audio_decode_vorbis_range(vorbis, &arena, samples, 0, capacity_frames) : 0;
+    stb_vorbis_close(vorbis);
+
+    // Tagged with the same key the runtime sample cache uses, so a cooked sound can be
+    // traced back to the exact OGG it was made from
+    bool written = frame_count > 0 &&
+        audio_cooked_write(output_path, audio_sample_cache_key(data, data_size, AUDIO_SAMPLES_PCM16), samples, frame_count);
+    arena_cleanup(&arena);
+
+    if (!written) {
+        fprintf(stderr, "Error: Failed to cook '%s'\n", input_path);
+        return 1;
+    }
+
+    printf("Cooked %s: %zu frames, %d Hz, %d channels\n", input_path, frame_count, AUDIO_SAMPLE_RATE, AUDIO_CHANNELS);
+    return 0;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file test.h
+ * @brief Checks for the tools/test_*.c programs. Unlike assert they stay on in release
+ * builds, and the first failure ends the program with a non-zero exit code.
+ */
+#pragma once
+#include "def.h"
+
+// stb_vorbis.c leaves a no-op CHECK behind, so include this after the engine headers
+#undef CHECK
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+        exit(1); \
+    } \
+} while (0)
+
+#define CHECK_MSG(cond, ...) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK failed: %s: ", __FILE__, __LINE__, #cond); \
+        fprintf(stderr, __VA_ARGS__); \
+        fputc('\n', stderr); \
+        exit(1); \
+    } \
+} while (0)
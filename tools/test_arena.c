@@ -0,0 +1,262 @@
+/**
+ * @file test_arena.c
+ * @brief Checks arena telemetry, spill blocks, aligned allocations and scratch arenas.
+ */
+#define ARENA_TELEMETRY 1
+#include "def.h"
+#include "arena.h"
+#include "thread.h"
+#include "test.h"
+
+// A hot-reloaded game DLL takes its __FILE__ literals with it when it is unloaded
+static void test_callsites_outlive_their_file_string(void) {
+    Arena arena = create_arena(MB(1));
+    char* file = (char*)malloc(32);
+    strcpy(file, "src/game.c");
+
+    arena_alloc_at(&arena, 16, file, 105);
+    char copy[32];
+    strcpy(copy, "src/game.c");
+    arena_alloc_at(&arena, 16, copy, 105);
+    memset(file, 'x', 31);
+    file[31] = '\0';
+    free(file);
+
+    ArenaStats* stats = arena_get_stats(&arena);
+    CHECK(stats->callsite_count == 1);
+
+    char report[512] = {};
+    FILE* out = tmpfile();
+    CHECK(out);
+    Arena* arenas[] = {&arena};
+    const char* names[] = {"test"};
+    arena_stats_write_csv(out, arenas, names, 1);
+    rewind(out);
+    usize length = fread(report, 1, sizeof(report) - 1, out);
+    fclose(out);
+    report[length] = '\0';
+    CHECK(strstr(report, "\"src/game.c\",105,2,32"));
+
+    arena_cleanup(&arena);
+}
+
+static void test_aligned_allocations_in_spill_blocks(void) {
+    Arena arena = create_arena_with_flags(MB(1), ARENA_FLAG_GROWABLE);
+    usize alignments[] = {16, 32, 64, 4096};
+
+    // Odd sizes leave the cursor 8-byte aligned in the base block and in every spill block
+    for (int i = 0; i < 4000; i++) {
+        CHECK(arena_alloc(&arena, 24 + (i % 5) * 8));
+        usize alignment = alignments[i % ARRAY_LEN(alignments)];
+        uint8* ptr = (uint8*)arena_alloc_aligned(&arena, 40 + i % 3 * 8, alignment);
+        CHECK(ptr);
+        CHECK_MSG((uintptr_t)ptr % alignment == 0, "%p is not %zu-byte aligned (spill %u)",
+                  (void*)ptr, alignment, arena_get_spill_count(&arena));
+        memset(ptr, 0xAB, 40);
+    }
+    CHECK(arena_get_spill_count(&arena) > 0);
+
+    // A block entered first by an aligned allocation aligns past its header
+    arena_reset(&arena);
+    CHECK(arena_alloc(&arena, MB(1) - 8));
+    uint8* ptr = (uint8*)arena_alloc_aligned(&arena, 256, 64);
+    CHECK(ptr && (uintptr_t)ptr % 64 == 0);
+    CHECK(arena_get_spill_count(&arena) == 1);
+
+    arena_cleanup(&arena);
+}
+
+static void test_spill_blocks_commit_lazily(void) {
+    Arena arena = create_arena_with_flags(MB(128), ARENA_FLAG_GROWABLE);
+    CHECK(arena_alloc(&arena, MB(128)));
+    usize base_committed = arena_get_committed(&arena);
+
+    // The spill block reserves as much as the base block but only commits what is used
+    CHECK(arena_alloc(&arena, KB(100)));
+    CHECK(arena_get_spill_count(&arena) == 1);
+    CHECK(arena.spill_first->size >= MB(128));
+    usize spill_committed = arena_get_committed(&arena) - base_committed;
+    CHECK_MSG(spill_committed <= KB(128), "spill block committed %zu bytes", spill_committed);
+
+    uint8* big = (uint8*)arena_alloc(&arena, MB(3));
+    CHECK(big);
+    big[MB(3) - 1] = 1;
+    spill_committed = arena_get_committed(&arena) - base_committed;
+    CHECK(spill_committed >= MB(3) && spill_committed <= MB(4));
+
+    arena_cleanup(&arena);
+}
+
+static void test_stats_count_spill_usage(void) {
+    Arena arena = create_arena_with_flags(MB(1), ARENA_FLAG_GROWABLE);
+    ArenaStats* stats = arena_get_stats(&arena);
+
+    CHECK(arena_alloc(&arena, KB(768)));
+    CHECK(arena_alloc(&arena, KB(512)));
+    CHECK(arena_alloc(&arena, KB(512)));
+    CHECK(arena_get_spill_count(&arena) == 2);
+    CHECK(arena_get_used(&arena) >= KB(768 + 512 + 512));
+    CHECK(stats->high_water == arena_get_used(&arena));
+    CHECK(stats->frame_peak == arena_get_used(&arena));
+
+    usize peak = stats->frame_peak;
+    arena_reset(&arena);
+    CHECK(arena_get_used(&arena) == 0);
+    CHECK(stats->last_frame_peak == peak && stats->max_frame_peak == peak);
+
+    // Temp scopes unwind spill usage as well
+    ArenaTemp temp = arena_temp_begin(&arena);
+    CHECK(arena_alloc(&arena, KB(900)));
+    CHECK(arena_alloc(&arena, KB(300)));
+    arena_temp_end(temp);
+    CHECK(arena_get_used(&arena) == 0);
+
+    arena_cleanup(&arena);
+}
+
+// Padding counts the same in the base block and in spill blocks, so byte totals compare
+static void test_stats_count_padding_alike(void) {
+    Arena arena = create_arena_with_flags(MB(1), ARENA_FLAG_GROWABLE);
+    ArenaStats* stats = arena_get_stats(&arena);
+
+    CHECK(arena_alloc(&arena, 8));
+    uint64 before = stats->bytes_allocated;
+    CHECK(arena_alloc_aligned(&arena, 64, 64));
+    uint64 base_bytes = stats->bytes_allocated - before;
+    CHECK(base_bytes == 56 + 64);
+
+    CHECK(arena_alloc(&arena, MB(1)));
+    CHECK(arena_get_spill_count(&arena) == 1);
+    CHECK(arena_alloc(&arena, 8));
+    usize offset = arena.spill_current->offset;
+    before = stats->bytes_allocated;
+    CHECK(arena_alloc_aligned(&arena, 64, 64));
+    CHECK(stats->bytes_allocated - before == arena.spill_current->offset - offset);
+    CHECK(stats->bytes_allocated - before == arena_align_up(offset, 64) - offset + 64);
+
+    arena_cleanup(&arena);
+}
+
+static void test_remaining_counts_spill_blocks(void) {
+    Arena arena = create_arena_with_flags(MB(1), ARENA_FLAG_GROWABLE);
+    CHECK(arena_get_remaining(&arena) == MB(1));
+
+    // Inside a spill block, what is left is the rest of that block
+    CHECK(arena_alloc(&arena, KB(768)));
+    CHECK(arena_alloc(&arena, KB(512)));
+    CHECK(arena_get_spill_count(&arena) == 1);
+    usize remaining = arena_get_remaining(&arena);
+    CHECK(remaining == arena.spill_current->size - arena.spill_current->offset);
+    CHECK(arena_alloc(&arena, remaining) && arena_get_spill_count(&arena) == 1);
+    CHECK(arena_get_remaining(&arena) == 0);
+
+    // After a reset the cached block is still there to allocate into
+    arena_reset(&arena);
+    remaining = arena_get_remaining(&arena);
+    CHECK(remaining == MB(1) + arena.spill_first->size - arena_spill_header_size());
+    uint32 spill_count = 0;
+    for (ArenaSpill* spill = arena.spill_first; spill; spill = spill->next) spill_count++;
+    CHECK(arena_alloc(&arena, MB(1)) && arena_alloc(&arena, remaining - MB(1)));
+    for (ArenaSpill* spill = arena.spill_first; spill; spill = spill->next) spill_count--;
+    CHECK(spill_count == 0 && arena_get_remaining(&arena) == 0);
+
+    arena_cleanup(&arena);
+}
+
+// A scratch scope never hands back an arena the caller is still allocating into
+static void test_scratch_avoids_conflicts(void) {
+    ArenaTemp outer = scratch_begin(nullptr, 0);
+    uint64* owned = (uint64*)arena_alloc(outer.arena, sizeof(uint64));
+    CHECK(owned);
+    *owned = 0x0123456789ABCDEFull;
+
+    for (int i = 0; i < 100; i++) {
+        Arena* conflict = outer.arena;
+        ArenaTemp inner = scratch_begin(&conflict, 1);
+        CHECK(inner.arena && inner.arena != conflict);
+        uint8* bytes = (uint8*)arena_alloc(inner.arena, KB(64));
+        CHECK(bytes);
+        memset(bytes, 0xCD, KB(64));
+
+        // And the other way round, nested inside the second one
+        Arena* nested_conflict = inner.arena;
+        ArenaTemp nested = scratch_begin(&nested_conflict, 1);
+        CHECK(nested.arena != nested_conflict);
+        scratch_end(nested);
+        scratch_end(inner);
+    }
+    CHECK(*owned == 0x0123456789ABCDEFull);
+
+    // Arenas that are not scratch arenas never conflict
+    Arena other = create_arena(MB(1));
+    Arena* unrelated = &other;
+    ArenaTemp temp = scratch_begin(&unrelated, 1);
+    CHECK(temp.arena == outer.arena);
+    scratch_end(temp);
+    arena_cleanup(&other);
+
+    scratch_end(outer);
+}
+
+typedef struct {
+    Arena* arenas[2];             // The thread's scratch arena, without and with a conflict
+    usize used_before_end;
+} ScratchTestThread;
+
+static void scratch_test_thread_proc(void* data) {
+    ScratchTestThread* result = (ScratchTestThread*)data;
+    ArenaTemp first = scratch_begin(nullptr, 0);
+    CHECK(arena_alloc(first.arena, MB(1)));
+    ArenaTemp second = scratch_begin(&first.arena, 1);
+    result->arenas[0] = first.arena;
+    result->arenas[1] = second.arena;
+    result->used_before_end = arena_get_used(first.arena);
+    scratch_end(second);
+    scratch_end(first);
+    scratch_thread_cleanup();
+}
+
+static void test_scratch_is_per_thread(void) {
+    ArenaTemp first = scratch_begin(nullptr, 0);
+    CHECK(arena_alloc(first.arena, KB(4)));
+    ArenaTemp second = scratch_begin(&first.arena, 1);
+    usize used = arena_get_used(first.arena);
+
+    ScratchTestThread results[2] = {};
+    Thread threads[2];
+    for (usize i = 0; i < ARRAY_LEN(threads); i++) {
+        CHECK(thread_create(&threads[i], scratch_test_thread_proc, &results[i]));
+    }
+    for (usize i = 0; i < ARRAY_LEN(threads); i++) thread_join(&threads[i]);
+
+    // Every thread has arenas of its own, nobody else's allocations move ours
+    Arena* seen[] = {
+        first.arena, second.arena,
+        results[0].arenas[0], results[0].arenas[1],
+        results[1].arenas[0], results[1].arenas[1],
+    };
+    for (usize i = 0; i < ARRAY_LEN(seen); i++) {
+        CHECK(seen[i]);
+        for (usize j = i + 1; j < ARRAY_LEN(seen); j++) {
+            CHECK_MSG(seen[i] != seen[j], "scratch arenas %zu and %zu are the same", i, j);
+        }
+    }
+    CHECK(results[0].used_before_end >= MB(1) && results[1].used_before_end >= MB(1));
+    CHECK(arena_get_used(first.arena) == used);
+
+    scratch_end(second);
+    scratch_end(first);
+}
+
+int main(void) {
+    test_callsites_outlive_their_file_string();
+    test_aligned_allocations_in_spill_blocks();
+    test_spill_blocks_commit_lazily();
+    test_stats_count_spill_usage();
+    test_stats_count_padding_alike();
+    test_remaining_counts_spill_blocks();
+    test_scratch_avoids_conflicts();
+    test_scratch_is_per_thread();
+    printf("test_arena: all checks passed\n");
+    return 0;
+}
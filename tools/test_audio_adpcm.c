@@ -0,0 +1,277 @@
+/**
+ * @file test_audio_adpcm.c
+ * @brief Checks IMA-ADPCM static sources: the round-trip error on known signals, block-wise
+ * reads from unaligned positions and across a loop point, that loading encodes the same blocks
+ * as encoding the full PCM decode without the PCM ever reaching the permanent arena, and that
+ * the mixer plays ADPCM exactly like the same samples as PCM16.
+ * Run from the repository root, it reads assets/sounds.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+#include "test.h"
+
+#include <math.h>
+#include <string.h>
+
+// Not a whole number of blocks, so the last one is padded
+constexpr usize ADPCM_TEST_FRAMES = 48000 + 77;
+
+static void adpcm_test_decode_all(int16* out, const uint8* blocks, usize frame_count, int channels) {
+    for (usize first = 0; first < frame_count; first += AUDIO_ADPCM_BLOCK_FRAMES) {
+        const uint8* block = blocks + first / AUDIO_ADPCM_BLOCK_FRAMES * audio_adpcm_block_bytes(channels);
+        audio_adpcm_decode_block(out + first * (usize)channels, block,
+                                 MIN(AUDIO_ADPCM_BLOCK_FRAMES, frame_count - first), channels);
+    }
+}
+
+static real64 adpcm_test_snr(const int16* reference, const int16* decoded, usize sample_count, int32* max_error) {
+    real64 signal = 0.0, noise = 0.0;
+    *max_error = 0;
+    for (usize i = 0; i < sample_count; i++) {
+        int32 error = (int32)decoded[i] - (int32)reference[i];
+        signal += (real64)reference[i] * reference[i];
+        noise += (real64)error * error;
+        *max_error = MAX(*max_error, error < 0 ? -error : error);
+    }
+    return 10.0 * log10(signal / MAX(noise, 1.0));
+}
+
+static void test_adpcm_round_trip(void) {
+    static int16 signal[ADPCM_TEST_FRAMES * 2], decoded[ADPCM_TEST_FRAMES * 2];
+    static uint8 blocks[(ADPCM_TEST_FRAMES / AUDIO_ADPCM_BLOCK_FRAMES + 1) * 2 * (AUDIO_ADPCM_HEADER_BYTES + AUDIO_ADPCM_BLOCK_FRAMES / 2)];
+
+    // Frequency, amplitude, and the SNR and peak error the IMA quantizer holds them to
+    struct {
+        real64 frequency;
+        real64 amplitude;
+        real64 min_snr_db;
+        int32 max_error;
+    } cases[] = {
+        {  440.0, 12000.0, 44.0, 150 },      // Measured 46.3 dB, peak 98
+        { 2500.0, 12000.0, 28.0, 800 },      // 29.7 dB, 537
+        {  100.0,   300.0, 50.0,   4 },      // Quiet, the step size adapts down: 54.8 dB, 1
+    };
+
+    for (int channels = 1; channels <= 2; channels++) {
+        for (usize c = 0; c < ARRAY_LEN(cases); c++) {
+            for (usize i = 0; i < ADPCM_TEST_FRAMES; i++) {
+                for (int ch = 0; ch < channels; ch++) {
+                    real64 phase = 2.0 * 3.14159265358979 * cases[c].frequency * (real64)i / 48000.0 + ch;
+                    signal[i * (usize)channels + (usize)ch] = (int16)lrint(cases[c].amplitude * sin(phase));
+                }
+            }
+
+            audio_adpcm_encode(blocks, signal, ADPCM_TEST_FRAMES, channels);
+            adpcm_test_decode_all(decoded, blocks, ADPCM_TEST_FRAMES, channels);
+
+            // The first samples of the stream are spent adapting the step size up
+            usize skip = 64 * (usize)channels;
+            int32 max_error = 0;
+            real64 snr = adpcm_test_snr(signal + skip, decoded + skip, ADPCM_TEST_FRAMES * (usize)channels - skip, &max_error);
+            CHECK_MSG(snr >= cases[c].min_snr_db && max_error <= cases[c].max_error,
+                      "%d channels, %.0f Hz at %.0f: SNR %.1f dB (want %.1f), max error %d (want %d)", channels,
+                      cases[c].frequency, cases[c].amplitude, snr, cases[c].min_snr_db, max_error, cases[c].max_error);
+        }
+    }
+}
+
+// A stream encoded a piece at a time gives the blocks of one encode
+static void test_adpcm_encode_in_pieces(void) {
+    static int16 signal[ADPCM_TEST_FRAMES * 2];
+    static uint8 whole[(ADPCM_TEST_FRAMES / AUDIO_ADPCM_BLOCK_FRAMES + 1) * 2 * (AUDIO_ADPCM_HEADER_BYTES + AUDIO_ADPCM_BLOCK_FRAMES / 2)];
+    static uint8 pieces[sizeof(whole)];
+    uint32 seed = 0x1234567u;
+    for (usize i = 0; i < ADPCM_TEST_FRAMES * 2; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        signal[i] = (int16)((int32)(seed >> 16) / 4 + (int32)(8000.0 * sin((real64)i * 0.01)));
+    }
+    audio_adpcm_encode(whole, signal, ADPCM_TEST_FRAMES, 2);
+
+    usize block_bytes = audio_adpcm_block_bytes(2);
+    AudioAdpcmEncoder encoder = {};
+    usize first = 0;
+    for (usize piece = 1; first < ADPCM_TEST_FRAMES; piece = piece % 7 + 1) {
+        usize frames = MIN(piece * AUDIO_ADPCM_BLOCK_FRAMES, ADPCM_TEST_FRAMES - first);
+        audio_adpcm_encode_blocks(&encoder, pieces + first / AUDIO_ADPCM_BLOCK_FRAMES * block_bytes,
+                                  signal + first * 2, frames, 2);
+        first += frames;
+    }
+    CHECK(memcmp(whole, pieces, audio_adpcm_size(ADPCM_TEST_FRAMES, 2)) == 0);
+}
+
+// Reads `count` frames from `position` the way the mixer does: a partial decode of each block
+// up to where the run ends, wrapping to the start at `frame_count`
+static void adpcm_test_read(int16* out, const uint8* blocks, usize frame_count, usize position, usize count) {
+    int16 block[AUDIO_ADPCM_BLOCK_FRAMES * 2];
+    usize block_bytes = audio_adpcm_block_bytes(2);
+    while (count > 0) {
+        if (position >= frame_count) position = 0;
+        usize offset = position % AUDIO_ADPCM_BLOCK_FRAMES;
+        usize frames = MIN(MIN(count, frame_count - position), AUDIO_ADPCM_BLOCK_FRAMES - offset);
+
+        audio_adpcm_decode_block(block, blocks + position / AUDIO_ADPCM_BLOCK_FRAMES * block_bytes, offset + frames, 2);
+        memcpy(out, block + offset * 2, frames * 2 * sizeof(int16));
+        out += frames * 2;
+        position += frames;
+        count -= frames;
+    }
+}
+
+static void test_adpcm_unaligned_reads(void) {
+    static int16 signal[ADPCM_TEST_FRAMES * 2], decoded[ADPCM_TEST_FRAMES * 2];
+    static uint8 blocks[(ADPCM_TEST_FRAMES / AUDIO_ADPCM_BLOCK_FRAMES + 1) * 2 * (AUDIO_ADPCM_HEADER_BYTES + AUDIO_ADPCM_BLOCK_FRAMES / 2)];
+    for (usize i = 0; i < ADPCM_TEST_FRAMES * 2; i++) {
+        signal[i] = (int16)lrint(10000.0 * sin((real64)i * 0.03));
+    }
+    audio_adpcm_encode(blocks, signal, ADPCM_TEST_FRAMES, 2);
+    adpcm_test_decode_all(decoded, blocks, ADPCM_TEST_FRAMES, 2);
+
+    // Starts inside blocks, on block edges, and runs that loop past the padded last block
+    usize starts[] = {0, 1, 255, 256, 257, 1000, 12345, ADPCM_TEST_FRAMES - 300, ADPCM_TEST_FRAMES - 1};
+    usize counts[] = {1, 7, 256, 800, 1777};
+    static int16 read[4000 * 2], expected[4000 * 2];
+
+    for (usize s = 0; s < ARRAY_LEN(starts); s++) {
+        for (usize c = 0; c < ARRAY_LEN(counts); c++) {
+            adpcm_test_read(read, blocks, ADPCM_TEST_FRAMES, starts[s], counts[c]);
+            for (usize i = 0; i < counts[c]; i++) {
+                usize frame = (starts[s] + i) % ADPCM_TEST_FRAMES;
+                expected[i * 2 + 0] = decoded[frame * 2 + 0];
+                expected[i * 2 + 1] = decoded[frame * 2 + 1];
+            }
+            CHECK_MSG(memcmp(read, expected, counts[c] * 2 * sizeof(int16)) == 0,
+                      "%zu frames from %zu differ from the full decode", counts[c], starts[s]);
+        }
+    }
+}
+
+typedef struct {
+    Arena permanent;
+    Arena transient;
+    AudioState* state;
+    AudioSourceHandle handle;
+    usize permanent_bytes;        // Committed by the load
+    usize transient_bytes;
+} AdpcmTestLoad;
+
+static void adpcm_test_load(AdpcmTestLoad* load, const uint8* data, usize size, AudioSampleFormat format) {
+    load->permanent = create_arena(GB(1));
+    load->transient = create_arena(GB(1));
+    load->state = create_audio_state(&load->permanent);
+    audio_set_static_format(load->state, format);
+
+    usize permanent = arena_get_committed(&load->permanent);
+    usize transient = arena_get_committed(&load->transient);
+    load->handle = create_audio_source_static_memory(&load->permanent, &load->transient, load->state, data, size, true, AUDIO_DECODE_RANGES_SERIAL);
+    CHECK(!slot_handle_is_null(load->handle));
+    load->permanent_bytes = arena_get_committed(&load->permanent) - permanent;
+    load->transient_bytes = arena_get_committed(&load->transient) - transient;
+}
+
+static void adpcm_test_unload(AdpcmTestLoad* load) {
+    audio_state_cleanup(load->state);
+    arena_cleanup(&load->permanent);
+    arena_cleanup(&load->transient);
+}
+
+static void test_adpcm_load(void) {
+    const char* files[] = {
+        "assets/sounds/Background.ogg",     // 44.1 kHz stereo, resampled while it encodes
+        "assets/sounds/Randomize.ogg",      // 48 kHz mono
+    };
+
+    for (usize f = 0; f < ARRAY_LEN(files); f++) {
+        Arena arena = create_arena(GB(1));
+        usize size = 0;
+        uint8* data = audio_read_file(&arena, files[f], &size);
+        CHECK_MSG(data, "could not read %s", files[f]);
+
+        AdpcmTestLoad pcm, adpcm;
+        adpcm_test_load(&pcm, data, size, AUDIO_SAMPLES_PCM16);
+        adpcm_test_load(&adpcm, data, size, AUDIO_SAMPLES_ADPCM);
+        AudioSource* pcm_source = audio_source_get(pcm.state, pcm.handle);
+        AudioSource* source = audio_source_get(adpcm.state, adpcm.handle);
+        usize frame_count = pcm_source->static_data.frame_count;
+
+        // The blocks are those of the full PCM decode, encoded in one go
+        CHECK(source->static_data.format == AUDIO_SAMPLES_ADPCM && source->static_data.frame_count == frame_count);
+        usize adpcm_size = audio_adpcm_size(frame_count, AUDIO_CHANNELS);
+        uint8* expected = arena_alloc(&arena, adpcm_size);
+        audio_adpcm_encode(expected, pcm_source->static_data.samples, frame_count, AUDIO_CHANNELS);
+        CHECK_MSG(memcmp(source->static_data.adpcm_blocks, expected, adpcm_size) == 0,
+                  "%s: blocks differ from encoding the PCM16 decode", files[f]);
+
+        // Only the blocks stay committed, the PCM passes through a chunk-sized transient window
+        usize pcm_size = frame_count * AUDIO_CHANNELS * sizeof(int16);
+        CHECK_MSG(adpcm.permanent_bytes < adpcm_size + KB(512), "%s: %zu KB committed for %zu KB of blocks",
+                  files[f], adpcm.permanent_bytes / 1024, adpcm_size / 1024);
+        CHECK_MSG(adpcm.transient_bytes <= KB(256), "%s: %zu KB of transient scratch", files[f], adpcm.transient_bytes / 1024);
+        printf("  %s: PCM16 commits %.2f MB, ADPCM %.2f MB (%.2f MB of blocks) and %zu KB of scratch\n", files[f],
+               pcm.permanent_bytes / 1048576.0, adpcm.permanent_bytes / 1048576.0, adpcm_size / 1048576.0,
+               adpcm.transient_bytes / 1024);
+        CHECK(pcm.permanent_bytes + KB(512) >= pcm_size && pcm.permanent_bytes > 3 * adpcm.permanent_bytes);
+
+        // Identical bytes share the blocks
+        AudioSourceHandle shared = create_audio_source_static_memory(&adpcm.permanent, &adpcm.transient, adpcm.state, data, size, false, AUDIO_DECODE_RANGES_SERIAL);
+        CHECK(audio_source_get(adpcm.state, shared)->static_data.adpcm_blocks == source->static_data.adpcm_blocks);
+
+        adpcm_test_unload(&pcm);
+        adpcm_test_unload(&adpcm);
+        arena_cleanup(&arena);
+    }
+}
+
+// The mixer decodes ADPCM block-wise, voices from any position and across the loop point
+// must mix exactly what the same samples mix as PCM16
+static void test_adpcm_mixer_matches_pcm(void) {
+    Arena arena = create_arena(GB(1));
+    usize size = 0;
+    uint8* data = audio_read_file(&arena, "assets/sounds/Randomize.ogg", &size);
+    CHECK(data);
+
+    AdpcmTestLoad adpcm;
+    adpcm_test_load(&adpcm, data, size, AUDIO_SAMPLES_ADPCM);
+    AudioSource* source = audio_source_get(adpcm.state, adpcm.handle);
+    usize frame_count = source->static_data.frame_count;
+
+    int16* decoded = arena_alloc(&arena, frame_count * AUDIO_CHANNELS * sizeof(int16));
+    adpcm_test_decode_all(decoded, source->static_data.adpcm_blocks, frame_count, AUDIO_CHANNELS);
+    AudioState* pcm_state = create_audio_state(&arena);
+    AudioSourceHandle pcm_handle = audio_source_insert_static(pcm_state, decoded, frame_count, true);
+
+    usize starts[] = {0, 1, 300, 4097, frame_count / 2 + 3, frame_count - 700, frame_count - 1};
+    real32 volumes[] = {1.0f, 0.8f, 0.5f, 0.3f, 0.9f, 0.7f, 0.6f};
+    for (usize i = 0; i < ARRAY_LEN(starts); i++) {
+        AudioVoiceHandle voice = audio_voice_play(adpcm.state, adpcm.handle);
+        AudioVoiceHandle pcm_voice = audio_voice_play(pcm_state, pcm_handle);
+        audio_voice_get(adpcm.state, voice)->position = starts[i];
+        audio_voice_get(pcm_state, pcm_voice)->position = starts[i];
+        audio_voice_set_volume(adpcm.state, voice, volumes[i]);
+        audio_voice_set_volume(pcm_state, pcm_voice, volumes[i]);
+    }
+
+    // Long enough for every voice to loop at least once
+    usize blocks = frame_count / (AUDIO_CAPACITY / AUDIO_CHANNELS) + 4;
+    for (usize b = 0; b < blocks; b++) {
+        audio_state_update(adpcm.state);
+        audio_state_update(pcm_state);
+        CHECK_MSG(memcmp(adpcm.state->bus, pcm_state->bus, sizeof(pcm_state->bus)) == 0, "bus differs in block %zu", b);
+        CHECK_MSG(memcmp(adpcm.state->audio, pcm_state->audio, sizeof(pcm_state->audio)) == 0, "output differs in block %zu", b);
+    }
+    CHECK(adpcm.state->real_voice_count == ARRAY_LEN(starts));
+
+    adpcm_test_unload(&adpcm);
+    audio_state_cleanup(pcm_state);
+    arena_cleanup(&arena);
+}
+
+int main(void) {
+    test_adpcm_round_trip();
+    test_adpcm_encode_in_pieces();
+    test_adpcm_unaligned_reads();
+    test_adpcm_load();
+    test_adpcm_mixer_matches_pcm();
+    printf("test_audio_adpcm: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file test_audio_batch.c
+ * @brief Checks create_audio_sources_static_batch against loading the same assets one at a
+ * time: the same samples, repeats within the batch and assets already cached share one
+ * decode, bad entries fail alone, and the callback reports every asset once.
+ * Run from the repository root, it reads assets/sounds.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+#include "test.h"
+
+#include <string.h>
+
+typedef struct {
+    _Atomic(uint32) loaded;
+    _Atomic(uint32) failed;
+} BatchTestCounts;
+
+static void batch_test_on_loaded(AudioLoadRequest* request, bool loaded, void* user_data) {
+    (void)request;
+    BatchTestCounts* counts = (BatchTestCounts*)user_data;
+    atomic_fetch_add(loaded ? &counts->loaded : &counts->failed, 1);
+}
+
+static const AudioSource* batch_test_source(AudioState* state, AudioSourceHandle handle) {
+    const AudioSource* source = audio_source_get(state, handle);
+    CHECK(source && source->static_data.samples && source->static_data.frame_count > 0);
+    return source;
+}
+
+static void test_batch_matches_serial_loads(void) {
+    Arena arena = create_arena(GB(1));
+    Arena transient = create_arena(GB(1));
+    const char* files[] = {
+        "assets/sounds/Background.ogg",
+        "assets/sounds/Explosion.ogg",
+        "assets/sounds/Randomize.ogg",
+    };
+
+    uint8* data[ARRAY_LEN(files)];
+    usize size[ARRAY_LEN(files)];
+    for (usize f = 0; f < ARRAY_LEN(files); f++) {
+        data[f] = audio_read_file(&arena, files[f], &size[f]);
+        CHECK_MSG(data[f], "could not read %s", files[f]);
+    }
+
+    // Every asset loaded on its own, the reference for the batch
+    AudioState* serial = create_audio_state(&arena);
+    AudioSourceHandle serial_handles[ARRAY_LEN(files)];
+    for (usize f = 0; f < ARRAY_LEN(files); f++) {
+        serial_handles[f] = create_audio_source_static_memory(&arena, &transient, serial, data[f], size[f], false, AUDIO_DECODE_RANGES_SERIAL);
+        CHECK(!slot_handle_is_null(serial_handles[f]));
+    }
+
+    // Explosion is already cached before the batch runs
+    AudioState* state = create_audio_state(&arena);
+    AudioSourceHandle cached = create_audio_source_static_memory(&arena, &transient, state, data[1], size[1], false, AUDIO_DECODE_RANGES_SERIAL);
+    CHECK(!slot_handle_is_null(cached));
+
+    uint8 garbage[256];
+    memset(garbage, 0x5A, sizeof(garbage));
+    AudioLoadRequest requests[] = {
+        { .data = data[0], .data_size = size[0], .loop = true },
+        { .data = data[1], .data_size = size[1] },                  // Already cached
+        { .filename = files[2] },                                   // Read by the batch
+        { .data = data[2], .data_size = size[2] },                  // Repeat of the previous one
+        { .filename = "assets/sounds/Missing.ogg" },
+        { .data = garbage, .data_size = sizeof(garbage) },
+    };
+
+    BatchTestCounts counts = {};
+    usize loaded = create_audio_sources_static_batch(
+        &arena, &transient, state, requests, ARRAY_LEN(requests), batch_test_on_loaded, &counts);
+    CHECK(loaded == 4);
+    CHECK(atomic_load(&counts.loaded) == 4 && atomic_load(&counts.failed) == 2);
+    CHECK(slot_handle_is_null(requests[4].handle) && slot_handle_is_null(requests[5].handle));
+
+    // Decoded in parallel into the same samples as one at a time
+    usize expected[] = {0, 1, 2, 2};
+    for (usize i = 0; i < ARRAY_LEN(expected); i++) {
+        const AudioSource* source = batch_test_source(state, requests[i].handle);
+        const AudioSource* reference = batch_test_source(serial, serial_handles[expected[i]]);
+        CHECK_MSG(source->static_data.frame_count == reference->static_data.frame_count,
+                  "request %zu: %zu frames, serial load %zu", i, source->static_data.frame_count,
+                  reference->static_data.frame_count);
+        CHECK_MSG(memcmp(source->static_data.samples, reference->static_data.samples,
+                         reference->static_data.frame_count * AUDIO_CHANNELS * sizeof(int16)) == 0,
+                  "request %zu: samples differ from the serial load", i);
+    }
+    CHECK(audio_source_get(state, requests[0].handle)->loop);
+
+    // The cached asset and the repeat share a single copy
+    CHECK(audio_source_get(state, requests[1].handle)->static_data.samples == audio_source_get(state, cached)->static_data.samples);
+    CHECK(audio_source_get(state, requests[3].handle)->static_data.samples == audio_source_get(state, requests[2].handle)->static_data.samples);
+    CHECK(slot_map_len(state->sources) == 5);
+
+    audio_state_cleanup(serial);
+    audio_state_cleanup(state);
+    arena_cleanup(&transient);
+    arena_cleanup(&arena);
+}
+
+int main(void) {
+    test_batch_matches_serial_loads();
+    printf("test_audio_batch: all checks passed\n");
+    return 0;
+}
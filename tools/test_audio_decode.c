@@ -0,0 +1,127 @@
+/**
+ * @file test_audio_decode.c
+ * @brief Checks the chunked static decoder against the whole-file path it replaced: decode
+ * everything, resample_linear_range to AUDIO_SAMPLE_RATE, then duplicate mono to stereo.
+ * Parallel range decoding is checked against the serial decode.
+ * Run from the repository root, it reads assets/sounds.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+#include "test.h"
+
+#include <string.h>
+
+static stb_vorbis* decode_test_open(const uint8* data, usize size) {
+    int error = 0;
+    stb_vorbis* vorbis = stb_vorbis_open_memory(data, (int)size, &error, nullptr);
+    CHECK_MSG(vorbis, "stb_vorbis error %d", error);
+    return vorbis;
+}
+
+// The load path before the chunked decoder, returns its frame count
+static usize decode_test_reference(Arena* arena, const uint8* data, usize size, int16** output) {
+    stb_vorbis* vorbis = decode_test_open(data, size);
+    stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+    int channels = info.channels;
+
+    usize input_frames = stb_vorbis_stream_length_in_samples(vorbis);
+    int16* input = arena_alloc(arena, input_frames * (usize)channels * sizeof(int16));
+    input_frames = (usize)stb_vorbis_get_samples_short_interleaved(
+        vorbis, channels, input, (int)(input_frames * (usize)channels));
+    stb_vorbis_close(vorbis);
+
+    int16* resampled = input;
+    usize frames = input_frames;
+    if (info.sample_rate != (uint32)AUDIO_SAMPLE_RATE) {
+        frames = resample_output_frames(input_frames, (int)info.sample_rate, (int)AUDIO_SAMPLE_RATE);
+        resampled = arena_alloc(arena, frames * (usize)channels * sizeof(int16));
+        resample_linear_range(input, input_frames, channels,
+                              resample_step((int)info.sample_rate, (int)AUDIO_SAMPLE_RATE), resampled, 0, frames);
+    }
+
+    *output = arena_alloc(arena, frames * AUDIO_CHANNELS * sizeof(int16));
+    for (usize i = 0; i < frames; i++) {
+        for (int ch = 0; ch < (int)AUDIO_CHANNELS; ch++) {
+            (*output)[i * AUDIO_CHANNELS + ch] = resampled[i * (usize)channels + MIN(ch, channels - 1)];
+        }
+    }
+    return frames;
+}
+
+static void test_chunked_decode_matches_whole_file(void) {
+    const char* files[] = {
+        "assets/sounds/Background.ogg",     // 44.1 kHz stereo, resampled
+        "assets/sounds/Explosion.ogg",      // 48 kHz mono
+        "assets/sounds/Randomize.ogg",
+    };
+
+    for (usize f = 0; f < ARRAY_LEN(files); f++) {
+        Arena arena = create_arena(GB(1));
+        usize size = 0;
+        uint8* data = audio_read_file(&arena, files[f], &size);
+        CHECK_MSG(data, "could not read %s", files[f]);
+
+        int16* reference = nullptr;
+        usize reference_frames = decode_test_reference(&arena, data, size, &reference);
+
+        stb_vorbis* vorbis = decode_test_open(data, size);
+        usize capacity = audio_decoded_capacity(vorbis);
+        CHECK_MSG(capacity == reference_frames, "%s: capacity %zu, whole-file decode %zu frames",
+                  files[f], capacity, reference_frames);
+
+        int16* samples = arena_alloc(&arena, capacity * AUDIO_CHANNELS * sizeof(int16));
+        usize frames = audio_decode_vorbis_range(vorbis, &arena, samples, 0, capacity);
+        stb_vorbis_close(vorbis);
+
+        CHECK_MSG(frames == reference_frames, "%s: %zu frames, whole-file decode %zu", files[f], frames, reference_frames);
+        CHECK_MSG(memcmp(samples, reference, frames * AUDIO_CHANNELS * sizeof(int16)) == 0,
+                  "%s: samples differ from the whole-file decode", files[f]);
+        arena_cleanup(&arena);
+    }
+}
+
+// Parallel range decoding must stitch to exactly the serial output, both where ranges seek
+// the Vorbis stream directly (48 kHz) and where they carry a resampler position (44.1 kHz)
+static void test_range_decode_matches_serial(void) {
+    const char* files[] = {"assets/sounds/Background.ogg", "assets/sounds/Randomize.ogg"};
+    usize range_counts[] = {2, 3, 4, 8};
+
+    for (usize f = 0; f < ARRAY_LEN(files); f++) {
+        Arena arena = create_arena(GB(1));
+        AudioLoadRequest request = { .filename = files[f] };
+        request.data = audio_read_file(&arena, files[f], &request.data_size);
+        CHECK_MSG(request.data, "could not read %s", files[f]);
+
+        stb_vorbis* vorbis = audio_load_request_open(&request);
+        usize capacity = audio_decoded_capacity(vorbis);
+        int16* serial = arena_alloc(&arena, capacity * AUDIO_CHANNELS * sizeof(int16));
+        usize serial_frames = audio_decode_vorbis_range(vorbis, &arena, serial, 0, capacity);
+        stb_vorbis_close(vorbis);
+        CHECK(serial_frames == capacity);
+
+        int16* ranged = arena_alloc(&arena, capacity * AUDIO_CHANNELS * sizeof(int16));
+        for (usize r = 0; r < ARRAY_LEN(range_counts); r++) {
+            ArenaTemp temp = arena_temp_begin(&arena);
+            memset(ranged, 0, capacity * AUDIO_CHANNELS * sizeof(int16));
+
+            vorbis = audio_load_request_open(&request);
+            usize frames = audio_decode_vorbis_ranges(&arena, &request, vorbis, ranged, capacity, range_counts[r]);
+            stb_vorbis_close(vorbis);
+
+            CHECK_MSG(frames == serial_frames, "%s, %zu ranges: %zu frames, serial %zu",
+                      files[f], range_counts[r], frames, serial_frames);
+            CHECK_MSG(memcmp(ranged, serial, frames * AUDIO_CHANNELS * sizeof(int16)) == 0,
+                      "%s, %zu ranges: samples differ from the serial decode", files[f], range_counts[r]);
+            arena_temp_end(temp);
+        }
+        arena_cleanup(&arena);
+    }
+}
+
+int main(void) {
+    test_chunked_decode_matches_whole_file();
+    test_range_decode_matches_serial();
+    printf("test_audio_decode: all checks passed\n");
+    return 0;
+}
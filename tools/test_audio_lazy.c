@@ -0,0 +1,247 @@
+/**
+ * @file test_audio_lazy.c
+ * @brief Plays a library of distinct lazy static sounds, several times larger decoded than
+ * its 1 MB budget, and checks the hit, miss and eviction counters, the budget, that identical
+ * bytes share one mapping, and that loading a file keeps one copy of its bytes however often
+ * it is registered. Run from the repository root, it reads assets/sounds.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+#include "test.h"
+
+#include <string.h>
+
+// One source slot is left for the looping source
+constexpr usize LAZY_TEST_SOUNDS = MAX_AUDIO_SOURCES - 1;
+constexpr usize LAZY_TEST_BUDGET = MB(1);
+constexpr usize LAZY_TEST_PLAYS = 1000;
+
+// Every sound is a copy of one of the small assets with a number stamped into its Vorbis
+// vendor string, so each hashes differently but decodes to the same samples
+typedef struct {
+    uint8* data[LAZY_TEST_SOUNDS];
+    usize size[LAZY_TEST_SOUNDS];
+} LazyTestLibrary;
+
+static void lazy_test_library(Arena* arena, LazyTestLibrary* library) {
+    const char* files[] = {"assets/sounds/Randomize.ogg", "assets/sounds/Explosion.ogg"};
+    const uint8 vendor[] = {0x03, 'v', 'o', 'r', 'b', 'i', 's', 11, 0, 0, 0};
+
+    for (usize f = 0; f < ARRAY_LEN(files); f++) {
+        usize size = 0;
+        uint8* original = audio_read_file(arena, files[f], &size);
+        CHECK_MSG(original, "could not read %s", files[f]);
+
+        // The comment header's vendor string is 11 bytes in both assets
+        usize stamp = 0;
+        for (usize i = 0; i + sizeof(vendor) <= size && !stamp; i++) {
+            if (memcmp(original + i, vendor, sizeof(vendor)) == 0) stamp = i + sizeof(vendor);
+        }
+        CHECK_MSG(stamp, "%s has no 11-byte vendor string", files[f]);
+
+        for (usize s = f; s < LAZY_TEST_SOUNDS; s += ARRAY_LEN(files)) {
+            library->data[s] = arena_alloc(arena, size);
+            library->size[s] = size;
+            memcpy(library->data[s], original, size);
+            char number[12];
+            snprintf(number, sizeof(number), "Lazy%07zu", s);
+            memcpy(library->data[s] + stamp, number, 11);
+        }
+    }
+}
+
+// Plays one voice of the source and mixes until it ends, so its samples become evictable
+static void lazy_test_play_through(AudioState* state, AudioSourceHandle handle) {
+    AudioVoiceHandle voice = audio_voice_play(state, handle);
+    CHECK(!slot_handle_is_null(voice));
+    while (slot_map_get(state->voices, voice)) audio_state_update(state);
+}
+
+static void test_lazy_library_within_budget(void) {
+    Arena arena = create_arena(GB(1));
+    AudioState* state = create_audio_state(&arena);
+    CHECK(audio_lazy_enable(&arena, state, LAZY_TEST_BUDGET));
+
+    static LazyTestLibrary library;
+    lazy_test_library(&arena, &library);
+
+    static AudioSourceHandle handles[LAZY_TEST_SOUNDS];
+    usize registered_bytes = arena_get_used(&arena);
+    for (usize i = 0; i < LAZY_TEST_SOUNDS; i++) {
+        handles[i] = create_audio_source_static_memory(&arena, &arena, state, library.data[i], library.size[i], false, AUDIO_DECODE_RANGES_SERIAL);
+        CHECK(!slot_handle_is_null(handles[i]));
+    }
+    // Registering keeps the OGG bytes only, nothing is decoded
+    CHECK(state->lazy.resident_bytes == 0 && state->lazy.misses == 0);
+    CHECK(arena_get_used(&arena) - registered_bytes < KB(256));
+
+    // Every first play misses, and the library is far larger than the budget
+    usize peak_bytes = 0, library_bytes = 0;
+    for (usize i = 0; i < LAZY_TEST_SOUNDS; i++) {
+        lazy_test_play_through(state, handles[i]);
+        library_bytes += audio_source_get(state, handles[i])->static_data.lazy->mapped_bytes;
+        peak_bytes = MAX(peak_bytes, state->lazy.resident_bytes);
+        CHECK(state->lazy.resident_bytes <= LAZY_TEST_BUDGET);
+    }
+    CHECK(state->lazy.misses == LAZY_TEST_SOUNDS && state->lazy.hits == 0);
+    CHECK(library_bytes > 3 * LAZY_TEST_BUDGET);
+    CHECK(state->lazy.evictions > 0 && state->lazy.evictions < LAZY_TEST_SOUNDS);
+
+    // Cycling through it in order is the worst case for LRU: every play misses, and the
+    // budget still holds
+    uint64 misses = state->lazy.misses;
+    for (usize play = 0; play < LAZY_TEST_PLAYS; play++) {
+        lazy_test_play_through(state, handles[play % LAZY_TEST_SOUNDS]);
+        peak_bytes = MAX(peak_bytes, state->lazy.resident_bytes);
+        CHECK(state->lazy.resident_bytes <= LAZY_TEST_BUDGET);
+    }
+    CHECK(state->lazy.misses == misses + LAZY_TEST_PLAYS && state->lazy.hits == 0);
+    misses = state->lazy.misses;
+
+    // The most recently played is still resident and hits, older ones were evicted
+    uint64 evictions = state->lazy.evictions;
+    usize last = (LAZY_TEST_PLAYS - 1) % LAZY_TEST_SOUNDS;
+    lazy_test_play_through(state, handles[last]);
+    CHECK(state->lazy.hits == 1 && state->lazy.misses == misses && state->lazy.evictions == evictions);
+
+    usize oldest = (last + 1) % LAZY_TEST_SOUNDS;
+    CHECK(atomic_load(&audio_source_get(state, handles[oldest])->static_data.lazy->state) == AUDIO_LAZY_EVICTED);
+    lazy_test_play_through(state, handles[oldest]);
+    CHECK(state->lazy.misses == misses + 1 && state->lazy.evictions > evictions);
+
+    // Samples a voice is playing stay resident however old they get. The looping source
+    // shares sound 1's samples, so its voice pins them for both.
+    AudioSourceHandle looping = create_audio_source_static_memory(&arena, &arena, state, library.data[1], library.size[1], true, AUDIO_DECODE_RANGES_SERIAL);
+    CHECK(audio_source_get(state, looping)->static_data.lazy == audio_source_get(state, handles[1])->static_data.lazy);
+    CHECK(!slot_handle_is_null(audio_voice_play(state, looping)));
+    for (usize play = 0; play < 100; play++) lazy_test_play_through(state, handles[2 + play % (LAZY_TEST_SOUNDS - 2)]);
+    CHECK(audio_source_get(state, handles[1])->static_data.samples != nullptr);
+    CHECK(state->lazy.resident_bytes <= LAZY_TEST_BUDGET);
+
+    printf("  %d sounds, %.1f MB decoded, peak %.1f MB resident: %llu hits, %llu misses, %llu evictions\n",
+           (int)LAZY_TEST_SOUNDS, library_bytes / 1048576.0, peak_bytes / 1048576.0,
+           (unsigned long long)state->lazy.hits, (unsigned long long)state->lazy.misses,
+           (unsigned long long)state->lazy.evictions);
+
+    audio_state_cleanup(state);
+    CHECK(state->lazy.resident_bytes == 0);
+    arena_cleanup(&arena);
+}
+
+static void test_lazy_identical_bytes_share_samples(void) {
+    Arena arena = create_arena(GB(1));
+    AudioState* state = create_audio_state(&arena);
+    CHECK(audio_lazy_enable(&arena, state, LAZY_TEST_BUDGET));
+
+    usize size = 0;
+    uint8* data = audio_read_file(&arena, "assets/sounds/Randomize.ogg", &size);
+    CHECK(data);
+
+    AudioSourceHandle first = create_audio_source_static_memory(&arena, &arena, state, data, size, false, AUDIO_DECODE_RANGES_SERIAL);
+    lazy_test_play_through(state, first);
+    usize resident = state->lazy.resident_bytes;
+    CHECK(resident > 0 && state->lazy.misses == 1);
+
+    // Registered after the first decode: playable at once, no second mapping
+    AudioSourceHandle second = create_audio_source_static_memory(&arena, &arena, state, data, size, false, AUDIO_DECODE_RANGES_SERIAL);
+    AudioSource* source = audio_source_get(state, second);
+    CHECK(source->static_data.lazy == audio_source_get(state, first)->static_data.lazy);
+    CHECK(source->static_data.samples == audio_source_get(state, first)->static_data.samples);
+    lazy_test_play_through(state, second);
+    CHECK(state->lazy.hits == 1 && state->lazy.misses == 1 && state->lazy.resident_bytes == resident);
+
+    // Destroying one keeps the samples for the other, destroying both releases them
+    audio_source_destroy(state, first);
+    CHECK(state->lazy.resident_bytes == resident && audio_source_get(state, second)->static_data.samples);
+    audio_source_destroy(state, second);
+    CHECK(state->lazy.resident_bytes == 0);
+
+    // Registered again later, the cache entry comes back to life with these bytes
+    AudioSourceHandle third = create_audio_source_static_memory(&arena, &arena, state, data, size, false, AUDIO_DECODE_RANGES_SERIAL);
+    lazy_test_play_through(state, third);
+    CHECK(state->lazy.misses == 2 && state->lazy.resident_bytes == resident);
+
+    audio_state_cleanup(state);
+    arena_cleanup(&arena);
+}
+
+// Decodes run on the decoder thread, voices wait at their start until the samples land
+static void test_lazy_decoder_thread(void) {
+    Arena arena = create_arena(GB(1));
+    AudioState* state = create_audio_state(&arena);
+    // Large enough for the whole library, so the second round only hits
+    CHECK(audio_lazy_enable(&arena, state, 16 * LAZY_TEST_BUDGET));
+    CHECK(audio_decoder_start(state));
+
+    static LazyTestLibrary library;
+    lazy_test_library(&arena, &library);
+
+    AudioSourceHandle handles[LAZY_TEST_SOUNDS];
+    for (usize i = 0; i < ARRAY_LEN(handles); i++) {
+        handles[i] = create_audio_source_static_memory(&arena, &arena, state, library.data[i], library.size[i], false, AUDIO_DECODE_RANGES_SERIAL);
+    }
+
+    for (usize round = 0; round < 2; round++) {
+        for (usize i = 0; i < ARRAY_LEN(handles); i++) {
+            CHECK(!slot_handle_is_null(audio_voice_play(state, handles[i])));
+        }
+        while (slot_map_len(state->voices) > 0) audio_state_update(state);
+        CHECK(state->lazy.pending_count == 0);
+    }
+    CHECK(state->lazy.misses == ARRAY_LEN(handles) && state->lazy.hits == ARRAY_LEN(handles));
+    for (usize i = 0; i < ARRAY_LEN(handles); i++) {
+        CHECK(audio_source_get(state, handles[i])->static_data.frame_count > 0);
+    }
+
+    audio_decoder_stop(state);
+    audio_state_cleanup(state);
+    arena_cleanup(&arena);
+}
+
+// Files are read into the transient arena, the permanent one keeps a single copy per asset
+static void test_lazy_file_copies_bytes_once(void) {
+    Arena arena = create_arena(GB(1));
+    Arena transient = create_arena(MB(64));
+    AudioState* state = create_audio_state(&arena);
+    CHECK(audio_lazy_enable(&arena, state, LAZY_TEST_BUDGET));
+    const char* file = "assets/sounds/Randomize.ogg";
+
+    usize used = arena_get_used(&arena);
+    AudioSourceHandle first = create_audio_source_static(&arena, &transient, state, file, false);
+    CHECK(!slot_handle_is_null(first));
+    AudioLazySamples* lazy = audio_source_get(state, first)->static_data.lazy;
+    CHECK(lazy->owns_data && arena_get_used(&transient) == 0);
+    usize registered = arena_get_used(&arena);
+    CHECK(registered - used >= lazy->data_size);
+
+    // Sharing the entry, or coming back to it once every source is gone, copies nothing
+    for (usize i = 0; i < 100; i++) {
+        AudioSourceHandle shared = create_audio_source_static(&arena, &transient, state, file, false);
+        CHECK(audio_source_get(state, shared)->static_data.lazy == lazy);
+        audio_source_destroy(state, shared);
+    }
+    audio_source_destroy(state, first);
+    for (usize i = 0; i < 100; i++) {
+        AudioSourceHandle revived = create_audio_source_static(&arena, &transient, state, file, false);
+        CHECK(audio_source_get(state, revived)->static_data.lazy == lazy);
+        if (i % 10 == 0) lazy_test_play_through(state, revived);
+        audio_source_destroy(state, revived);
+    }
+    CHECK_MSG(arena_get_used(&arena) == registered, "%zu permanent bytes after 200 registrations, %zu after one",
+              arena_get_used(&arena), registered);
+    CHECK(arena_get_used(&transient) == 0 && state->lazy.misses == 10);
+
+    audio_state_cleanup(state);
+    arena_cleanup(&transient);
+    arena_cleanup(&arena);
+}
+
+int main(void) {
+    test_lazy_library_within_budget();
+    test_lazy_identical_bytes_share_samples();
+    test_lazy_file_copies_bytes_once();
+    test_lazy_decoder_thread();
+    printf("test_audio_lazy: all checks passed\n");
+    return 0;
+}
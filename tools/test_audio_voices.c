@@ -0,0 +1,211 @@
+/**
+ * @file test_audio_voices.c
+ * @brief Checks the voice pool: stealing by priority then age when the pool is full, the
+ * per-source instance limit, that triggering voices never allocates, and that inaudible
+ * voices go virtual and resume sample-exact.
+ */
+#include "def.h"
+#include "arena.h"
+#include "audio.h"
+#include "test.h"
+
+#include <string.h>
+
+constexpr usize VOICE_TEST_FRAMES = 48000;
+
+static int16 voice_test_samples[VOICE_TEST_FRAMES * AUDIO_CHANNELS];
+
+static void voice_test_fill_samples(void) {
+    uint32 seed = 0xA5A5A5A5u;
+    for (usize i = 0; i < ARRAY_LEN(voice_test_samples); i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        voice_test_samples[i] = (int16)(seed >> 16) / 8;
+    }
+}
+
+static AudioSourceHandle voice_test_source(AudioState* state, uint8 priority, bool loop) {
+    AudioSourceHandle handle = audio_source_insert_static(state, voice_test_samples, VOICE_TEST_FRAMES, loop);
+    CHECK(!slot_handle_is_null(handle));
+    audio_source_set_priority(state, handle, priority);
+    return handle;
+}
+
+static void test_full_pool_steals_lowest_priority_then_oldest(void) {
+    Arena arena = create_arena(MB(64));
+    AudioState* state = create_audio_state(&arena);
+    AudioSourceHandle low = voice_test_source(state, 1, false);
+    AudioSourceHandle mid = voice_test_source(state, 5, false);
+    AudioSourceHandle high = voice_test_source(state, 10, false);
+
+    // Alternating priorities, so the oldest voice is not the lowest priority one
+    static AudioVoiceHandle voices[MAX_AUDIO_VOICES];
+    for (usize i = 0; i < MAX_AUDIO_VOICES; i++) {
+        voices[i] = audio_voice_play(state, i % 2 == 0 ? mid : low);
+        CHECK(!slot_handle_is_null(voices[i]));
+    }
+    CHECK(slot_map_is_full(state->voices));
+
+    // The oldest low voice (index 1) goes, not the older mid voice at index 0
+    AudioVoiceHandle stealer = audio_voice_play(state, high);
+    CHECK(!slot_handle_is_null(stealer));
+    CHECK(audio_voice_get(state, voices[1]) == nullptr);
+    CHECK(audio_voice_get(state, voices[0]) != nullptr);
+    CHECK(slot_map_len(state->voices) == MAX_AUDIO_VOICES);
+
+    // Equal priority may steal too, again the oldest of the lowest
+    CHECK(!slot_handle_is_null(audio_voice_play(state, low)));
+    CHECK(audio_voice_get(state, voices[3]) == nullptr && audio_voice_get(state, voices[5]) != nullptr);
+
+    // A pool full of higher priorities rejects the trigger and keeps every voice
+    for (usize i = 1; i < MAX_AUDIO_VOICES; i++) {
+        CHECK(!slot_handle_is_null(audio_voice_play(state, high)));
+    }
+    CHECK(audio_source_get(state, low)->voice_count == 0 && audio_source_get(state, mid)->voice_count == 0);
+    CHECK(audio_source_get(state, high)->voice_count == MAX_AUDIO_VOICES);
+    CHECK(slot_handle_is_null(audio_voice_play(state, low)));
+    CHECK(slot_handle_is_null(audio_voice_play(state, mid)));
+    CHECK(audio_voice_get(state, stealer) != nullptr);
+
+    audio_state_cleanup(state);
+    arena_cleanup(&arena);
+}
+
+static void test_source_voice_limit(void) {
+    Arena arena = create_arena(MB(64));
+    AudioState* state = create_audio_state(&arena);
+    AudioSourceHandle limited = voice_test_source(state, 0, false);
+    AudioSourceHandle other = voice_test_source(state, 0, false);
+    audio_source_set_voice_limit(state, limited, 3);
+
+    // An older voice of another source is never the victim of the limit
+    AudioVoiceHandle other_voice = audio_voice_play(state, other);
+    AudioVoiceHandle voices[3];
+    for (usize i = 0; i < ARRAY_LEN(voices); i++) {
+        voices[i] = audio_voice_play(state, limited);
+        CHECK(!slot_handle_is_null(voices[i]));
+    }
+    CHECK(audio_source_get(state, limited)->voice_count == 3);
+
+    // At the limit a trigger replaces the source's own oldest voice
+    for (usize round = 0; round < 10; round++) {
+        AudioVoiceHandle voice = audio_voice_play(state, limited);
+        CHECK(!slot_handle_is_null(voice));
+        CHECK(audio_voice_get(state, voices[round % 3]) == nullptr);
+        voices[round % 3] = voice;
+        CHECK(audio_source_get(state, limited)->voice_count == 3);
+        CHECK(slot_map_len(state->voices) == 4 && audio_voice_get(state, other_voice) != nullptr);
+    }
+
+    // Raising the limit lets it overlap again, finished voices free their place
+    audio_source_set_voice_limit(state, limited, 0);
+    for (usize i = 0; i < 20; i++) CHECK(!slot_handle_is_null(audio_voice_play(state, limited)));
+    CHECK(audio_source_get(state, limited)->voice_count == 23);
+    while (slot_map_len(state->voices) > 0) audio_state_update(state);
+    CHECK(audio_source_get(state, limited)->voice_count == 0 && audio_source_get(state, other)->voice_count == 0);
+
+    audio_state_cleanup(state);
+    arena_cleanup(&arena);
+}
+
+// Voices live in the fixed pool, a trigger never allocates
+static void test_triggers_allocate_nothing(void) {
+    Arena arena = create_arena(MB(64));
+    AudioState* state = create_audio_state(&arena);
+    AudioSourceHandle sources[] = {
+        voice_test_source(state, 0, false),
+        voice_test_source(state, 3, true),
+        voice_test_source(state, 7, false),
+    };
+    audio_source_set_voice_limit(state, sources[1], 16);
+
+    usize used = arena_get_used(&arena);
+    usize committed = arena_get_committed(&arena);
+    for (usize i = 0; i < 1000; i++) {
+        audio_voice_play(state, sources[i % ARRAY_LEN(sources)]);
+        if (i % 7 == 0) audio_state_update(state);
+    }
+    CHECK(slot_map_len(state->voices) > 0);
+    CHECK(arena_get_used(&arena) == used && arena_get_committed(&arena) == committed);
+
+    audio_state_cleanup(state);
+    arena_cleanup(&arena);
+}
+
+static void test_virtual_voices_resume_sample_exact(void) {
+    Arena arena = create_arena(MB(64));
+    constexpr usize frames_per_block = AUDIO_CAPACITY / AUDIO_CHANNELS;
+    constexpr usize virtual_blocks = 70; // Past the end of the sample, so the loop wraps
+
+    // The reference voice is audible throughout, the other one silent for a while
+    AudioState* reference = create_audio_state(&arena);
+    AudioState* state = create_audio_state(&arena);
+    AudioSourceHandle reference_source = voice_test_source(reference, 0, true);
+    AudioSourceHandle looping = voice_test_source(state, 0, true);
+    AudioSourceHandle one_shot = voice_test_source(state, 0, false);
+
+    AudioVoiceHandle reference_voice = audio_voice_play(reference, reference_source);
+    AudioVoiceHandle voice = audio_voice_play(state, looping);
+    AudioVoiceHandle silent_one_shot = audio_voice_play(state, one_shot);
+    AudioVoiceHandle audible_one_shot = audio_voice_play(state, one_shot);
+    audio_voice_set_volume(state, voice, 0.0f);
+    audio_voice_set_volume(state, silent_one_shot, AUDIO_AUDIBLE_THRESHOLD * 0.5f);
+
+    for (usize block = 1; block <= virtual_blocks; block++) {
+        audio_state_update(reference);
+        audio_state_update(state);
+
+        // The playhead moves a whole block per update and wraps when looping
+        usize expected = (block * frames_per_block) % VOICE_TEST_FRAMES;
+        CHECK_MSG(audio_voice_get(state, voice)->position == expected,
+                  "block %zu: virtual playhead at %zu, expected %zu", block,
+                  audio_voice_get(state, voice)->position, expected);
+        // The mixed voice only wraps when it next mixes, an end position means the start
+        CHECK(audio_voice_get(reference, reference_voice)->position % VOICE_TEST_FRAMES == expected);
+
+        // One-shots end on the same block whether mixed or virtual
+        bool one_shots_playing = block * frames_per_block < VOICE_TEST_FRAMES;
+        CHECK((audio_voice_get(state, silent_one_shot) != nullptr) == one_shots_playing);
+        CHECK((audio_voice_get(state, audible_one_shot) != nullptr) == one_shots_playing);
+
+        // Both one-shots are still counted on the block they finish
+        bool one_shots_counted = block * frames_per_block <= VOICE_TEST_FRAMES;
+        uint32 expected_real = one_shots_counted ? 1 : 0;
+        uint32 expected_virtual = one_shots_counted ? 2 : 1;
+        CHECK_MSG(state->real_voice_count == expected_real && state->virtual_voice_count == expected_virtual,
+                  "block %zu: %u real and %u virtual voices", block, state->real_voice_count,
+                  state->virtual_voice_count);
+        CHECK(reference->real_voice_count == 1 && reference->virtual_voice_count == 0);
+    }
+
+    // Realized again, it mixes exactly what the always audible voice mixes
+    audio_voice_set_volume(state, voice, 1.0f);
+    for (usize block = 0; block < 8; block++) {
+        audio_state_update(reference);
+        audio_state_update(state);
+        CHECK(state->real_voice_count == 1 && state->virtual_voice_count == 0);
+        CHECK_MSG(memcmp(state->bus, reference->bus, sizeof(state->bus)) == 0,
+                  "block %zu after realizing: bus differs from the reference", block);
+        CHECK(memcmp(state->audio, reference->audio, sizeof(state->audio)) == 0);
+    }
+
+    // Master volume below the threshold virtualizes every voice at once
+    state->volume = 0.0f;
+    audio_state_update(state);
+    CHECK(state->real_voice_count == 0 && state->virtual_voice_count == 1);
+
+    audio_state_cleanup(state);
+    audio_state_cleanup(reference);
+    arena_cleanup(&arena);
+}
+
+int main(void) {
+    voice_test_fill_samples();
+    test_full_pool_steals_lowest_priority_then_oldest();
+    test_source_voice_limit();
+    test_triggers_allocate_nothing();
+    test_virtual_voices_resume_sample_exact();
+    printf("test_audio_voices: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file test_level.c
+ * @brief Soak test of the level arena tier: 1,000 level loads through game_level_update, with
+ * the committed bytes and high-water mark of the level arena flat after the first one.
+ */
+#define ARENA_TELEMETRY 1
+#include "../src/game.c"
+#include "test.h"
+
+constexpr uint32 LEVEL_TEST_LOADS = 1000;
+
+static void test_level_loads_keep_memory_flat(void) {
+    Arena permanent_storage = create_arena(MB(64));
+    // As in src/main.c
+    Arena level_storage = create_arena_with_flags(MB(32), ARENA_FLAG_DECOMMIT_ON_RESET);
+    GameState* state = create_game_state(&permanent_storage, &level_storage);
+    usize permanent_used = arena_get_used(&permanent_storage);
+
+    usize committed = 0;
+    usize high_water = 0;
+    for (uint32 load = 0; load < LEVEL_TEST_LOADS; load++) {
+        state->requested_level = load;
+        game_level_update(state);
+        CHECK(state->level && state->level->index == load);
+
+        // Whatever the previous level left behind is gone with the reset
+        for (int x = 0; x < WORLD_GRID.x; x++) {
+            for (int y = 0; y < WORLD_GRID.y; y++) {
+                CHECK(!state->level->world_grid[x][y].is_visible);
+                state->level->world_grid[x][y].is_visible = (x + y + (int)load) % 3 == 0;
+            }
+        }
+
+        // The same level again is not a reload
+        Level* level = state->level;
+        game_level_update(state);
+        CHECK(state->level == level);
+
+        if (load == 0) {
+            committed = arena_get_committed(&level_storage);
+            high_water = level_storage.stats.high_water;
+            CHECK(high_water >= sizeof(Level));
+        }
+        CHECK_MSG(arena_get_committed(&level_storage) == committed,
+                  "load %u: %zu bytes committed, %zu after the first load", load,
+                  arena_get_committed(&level_storage), committed);
+        CHECK_MSG(level_storage.stats.high_water == high_water,
+                  "load %u: high water %zu, %zu after the first load", load,
+                  level_storage.stats.high_water, high_water);
+    }
+
+    CHECK(level_storage.stats.reset_count == LEVEL_TEST_LOADS);
+    CHECK(arena_get_used(&permanent_storage) == permanent_used);
+    printf("  %u level loads: %zu KB committed, %zu KB high water\n", LEVEL_TEST_LOADS,
+           committed / 1024, high_water / 1024);
+
+    game_level_exit(state);
+    CHECK(state->level == nullptr);
+    arena_cleanup(&level_storage);
+    arena_cleanup(&permanent_storage);
+}
+
+int main(void) {
+    test_level_loads_keep_memory_flat();
+    printf("test_level: all checks passed\n");
+    return 0;
+}
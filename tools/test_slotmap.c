@@ -0,0 +1,131 @@
+/**
+ * @file test_slotmap.c
+ * @brief Checks slot map handles: stale handles stop resolving, reused slots get a new
+ * generation, removal keeps every survivor reachable, and clear leaves handles stale.
+ */
+#include "def.h"
+#include "slotmap.h"
+#include "test.h"
+
+constexpr usize SLOT_TEST_CAPACITY = 64;
+
+typedef SLOT_MAP(uint64, SLOT_TEST_CAPACITY) SlotTestMap;
+
+static void test_null_handle_never_resolves(void) {
+    static SlotTestMap map;
+    SlotHandle null_handle = {};
+    CHECK(slot_handle_is_null(null_handle));
+    CHECK(slot_map_get(map, null_handle) == nullptr);
+
+    // Not even once slot 0 is live
+    SlotHandle handle = slot_map_insert(map, 7);
+    CHECK(handle.index == 0 && !slot_handle_is_null(handle));
+    CHECK(slot_map_get(map, null_handle) == nullptr);
+    CHECK(!slot_map_remove(map, null_handle));
+    CHECK(slot_map_len(map) == 1);
+
+    // Out-of-range indices are rejected as well
+    SlotHandle out_of_range = { .index = SLOT_TEST_CAPACITY, .generation = 1 };
+    CHECK(slot_map_get(map, out_of_range) == nullptr);
+}
+
+static void test_stale_handles_and_reuse(void) {
+    static SlotTestMap map;
+    SlotHandle first = slot_map_insert(map, 100);
+    CHECK(*slot_map_get(map, first) == 100);
+
+    CHECK(slot_map_remove(map, first));
+    CHECK(slot_map_get(map, first) == nullptr);
+    CHECK(!slot_map_remove(map, first));
+
+    // The freed slot comes back with a generation the old handle does not match
+    SlotHandle second = slot_map_insert(map, 200);
+    CHECK(second.index == first.index && second.generation != first.generation);
+    CHECK(slot_map_get(map, first) == nullptr);
+    CHECK(*slot_map_get(map, second) == 200);
+
+    // Many rounds through the same slot never resurrect an older handle
+    SlotHandle history[100];
+    for (usize i = 0; i < ARRAY_LEN(history); i++) {
+        CHECK(slot_map_remove(map, second));
+        history[i] = second;
+        second = slot_map_insert(map, 300 + i);
+        CHECK(second.index == first.index);
+        for (usize j = 0; j <= i; j++) {
+            CHECK(!slot_handle_equals(history[j], second) && slot_map_get(map, history[j]) == nullptr);
+        }
+    }
+}
+
+static void test_remove_from_middle_keeps_survivors(void) {
+    static SlotTestMap map;
+    SlotHandle handles[SLOT_TEST_CAPACITY];
+    for (usize i = 0; i < SLOT_TEST_CAPACITY; i++) {
+        handles[i] = slot_map_insert(map, (uint64)i * 10);
+    }
+    CHECK(slot_map_is_full(map));
+    CHECK(slot_handle_is_null(slot_map_insert(map, 1)));
+
+    // Every third value goes, holes are filled from the end
+    bool removed[SLOT_TEST_CAPACITY] = {};
+    for (usize i = 1; i < SLOT_TEST_CAPACITY; i += 3) {
+        CHECK(slot_map_remove(map, handles[i]));
+        removed[i] = true;
+    }
+
+    usize survivors = 0;
+    for (usize i = 0; i < SLOT_TEST_CAPACITY; i++) {
+        uint64* value = slot_map_get(map, handles[i]);
+        if (removed[i]) {
+            CHECK(value == nullptr);
+        } else {
+            CHECK_MSG(value && *value == (uint64)i * 10, "survivor %zu lost its value", i);
+            survivors++;
+        }
+    }
+    CHECK(slot_map_len(map) == survivors);
+
+    // Iterating the dense array reaches each survivor exactly once through its own handle
+    usize seen = 0;
+    for (usize d = 0; d < slot_map_len(map); d++) {
+        SlotHandle handle = slot_map_handle_at(map, d);
+        CHECK(slot_map_get(map, handle) == &map.data[d]);
+        usize i = (usize)(map.data[d] / 10);
+        CHECK(!removed[i] && slot_handle_equals(handle, handles[i]));
+        seen++;
+    }
+    CHECK(seen == survivors);
+}
+
+static void test_clear_leaves_handles_stale(void) {
+    static SlotTestMap map;
+    SlotHandle handles[16];
+    for (usize i = 0; i < ARRAY_LEN(handles); i++) {
+        handles[i] = slot_map_insert(map, i);
+    }
+
+    slot_map_clear(map);
+    CHECK(slot_map_len(map) == 0);
+    for (usize i = 0; i < ARRAY_LEN(handles); i++) {
+        CHECK(slot_map_get(map, handles[i]) == nullptr);
+    }
+
+    // Refilling reuses the slots, still without reviving the old handles
+    for (usize i = 0; i < ARRAY_LEN(handles); i++) {
+        SlotHandle handle = slot_map_insert(map, 1000 + i);
+        CHECK(handle.index < ARRAY_LEN(handles));
+        CHECK(*slot_map_get(map, handle) == 1000 + i);
+    }
+    for (usize i = 0; i < ARRAY_LEN(handles); i++) {
+        CHECK(slot_map_get(map, handles[i]) == nullptr);
+    }
+}
+
+int main(void) {
+    test_null_handle_never_resolves();
+    test_stale_handles_and_reuse();
+    test_remove_from_middle_keeps_survivors();
+    test_clear_leaves_handles_stale();
+    printf("test_slotmap: all checks passed\n");
+    return 0;
+}